@@ -0,0 +1,301 @@
+#include <configly/configly.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ===================================================================
+// Reader-side benchmark for Configly.
+//
+// Every scenario runs R reader threads against W writer threads for a
+// fixed time and reports:
+//   - ns/op        : elapsed time x readers / total reads (time per read
+//                    as seen by one reader thread)
+//   - p50/p99/p999 : latency of individually timed (sampled) reads
+//   - retries/op   : readRetries() delta divided by the number of reads
+//
+// Usage: configly_bench [--quick] [--duration-ms N] [--readers 1,4,16]
+//                       [--writers 0,1,4] [--sizes 8,64,4096]
+//
+// configly_bench_packed is the same harness built with CONFIGLY_PACKED_LAYOUT;
+// compare the two for the effect of the cache-line padded buffers (sizes that
+// are not a multiple of the line size show it best).
+// ===================================================================
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+template<typename V>
+inline void doNotOptimize(const V& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+// head is what get()/set() touch, tail pads the struct to Size bytes
+template<std::size_t Size>
+struct Payload {
+    std::uint64_t head;
+    unsigned char tail[Size - sizeof(std::uint64_t)];
+};
+
+template<>
+struct Payload<sizeof(std::uint64_t)> {
+    std::uint64_t head;
+};
+
+// readRetries() needs a counting stats policy
+template<typename C>
+using BenchConfigly = Configly<C, 1, 2, configly::AtomicStats>;
+
+enum class ReadOp { GetAll, Get, Cached };
+enum class WriteOp { Update, Set };
+
+struct Options {
+    std::chrono::milliseconds duration{100};
+    std::vector<int> readers{1, 4, 16, 64};
+    std::vector<int> writers{0, 1, 4};
+    std::vector<std::size_t> sizes{8, 40, 64, 256, 1024, 4096, 16384};
+};
+
+struct Result {
+    double nsPerOp = 0;
+    double p50 = 0;
+    double p99 = 0;
+    double p999 = 0;
+    double retriesPerOp = 0;
+};
+
+// one read in every kSampleEvery is timed on its own
+constexpr int kSampleEvery = 64;
+
+double clockOverheadNs() {
+    constexpr int kRounds = 10000;
+    std::vector<double> samples;
+    samples.reserve(kRounds);
+    for (int i = 0; i < kRounds; ++i) {
+        const auto t0 = Clock::now();
+        const auto t1 = Clock::now();
+        samples.push_back(std::chrono::duration<double, std::nano>(t1 - t0).count());
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    const std::size_t idx = std::min(sorted.size() - 1,
+                                     static_cast<std::size_t>(p * static_cast<double>(sorted.size())));
+    return sorted[idx];
+}
+
+template<std::size_t Size>
+Result runScenario(const Options& opt, int readers, int writers, ReadOp readOp, WriteOp writeOp,
+                   double overheadNs) {
+    using Config = Payload<Size>;
+    auto& cfg = BenchConfigly<Config>::instance();
+    cfg.setDefault(Config{});
+
+    std::atomic<int> ready{0};
+    std::atomic<bool> go{false};
+    std::atomic<bool> stop{false};
+
+    std::vector<std::uint64_t> reads(static_cast<std::size_t>(readers), 0);
+    std::vector<std::vector<double>> samples(static_cast<std::size_t>(readers));
+
+    std::vector<std::thread> threads;
+    for (int w = 0; w < writers; ++w) {
+        threads.emplace_back([&, w]() {
+            Config next{};
+            std::uint64_t i = static_cast<std::uint64_t>(w) << 48;
+            ready.fetch_add(1);
+            while (!go.load(std::memory_order_acquire)) {}
+            while (!stop.load(std::memory_order_relaxed)) {
+                ++i;
+                if (writeOp == WriteOp::Update) {
+                    next.head = i;
+                    cfg.update(next);
+                } else {
+                    cfg.set(&Config::head, i);
+                }
+            }
+        });
+    }
+
+    for (int r = 0; r < readers; ++r) {
+        threads.emplace_back([&, r]() {
+            std::vector<double>& mine = samples[static_cast<std::size_t>(r)];
+            mine.reserve(1 << 16);
+            std::uint64_t count = 0;
+            Config snapshot;
+            typename BenchConfigly<Config>::LocalCache cache(cfg);
+            ready.fetch_add(1);
+            while (!go.load(std::memory_order_acquire)) {}
+            while (!stop.load(std::memory_order_relaxed)) {
+                for (int k = 0; k < kSampleEvery; ++k) {
+                    const bool timed = (k == 0) && mine.size() < mine.capacity();
+                    const auto t0 = timed ? Clock::now() : Clock::time_point{};
+                    if (readOp == ReadOp::GetAll) {
+                        cfg.getAll(snapshot);
+                        doNotOptimize(snapshot);
+                    } else if (readOp == ReadOp::Get) {
+                        doNotOptimize(cfg.get(&Config::head));
+                    } else {
+                        doNotOptimize(cache.get(&Config::head));
+                    }
+                    if (timed) {
+                        const double ns = std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+                        mine.push_back(std::max(0.0, ns - overheadNs));
+                    }
+                }
+                count += kSampleEvery;
+            }
+            reads[static_cast<std::size_t>(r)] = count;
+        });
+    }
+
+    while (ready.load() != readers + writers) {
+        std::this_thread::yield();
+    }
+    const std::uint64_t retriesBefore = cfg.readRetries();
+    const auto start = Clock::now();
+    go.store(true, std::memory_order_release);
+    std::this_thread::sleep_for(opt.duration);
+    stop.store(true);
+    for (auto& t : threads) {
+        t.join();
+    }
+    const double elapsedNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    const std::uint64_t retries = cfg.readRetries() - retriesBefore;
+
+    std::uint64_t totalReads = 0;
+    std::vector<double> all;
+    for (int r = 0; r < readers; ++r) {
+        totalReads += reads[static_cast<std::size_t>(r)];
+        all.insert(all.end(), samples[static_cast<std::size_t>(r)].begin(),
+                   samples[static_cast<std::size_t>(r)].end());
+    }
+    std::sort(all.begin(), all.end());
+
+    Result res;
+    if (totalReads > 0) {
+        // per reader thread: wall time / reads done by that thread, averaged
+        res.nsPerOp = elapsedNs * readers / static_cast<double>(totalReads);
+        res.retriesPerOp = static_cast<double>(retries) / static_cast<double>(totalReads);
+    }
+    res.p50 = percentile(all, 0.50);
+    res.p99 = percentile(all, 0.99);
+    res.p999 = percentile(all, 0.999);
+    return res;
+}
+
+const char* name(ReadOp op) {
+    switch (op) {
+        case ReadOp::GetAll: return "getAll";
+        case ReadOp::Get:    return "get";
+        default:             return "cached";
+    }
+}
+const char* name(WriteOp op) { return op == WriteOp::Update ? "update" : "set"; }
+
+template<std::size_t Size>
+void runSize(const Options& opt, double overheadNs) {
+    for (int readers : opt.readers) {
+        for (int writers : opt.writers) {
+            for (ReadOp readOp : {ReadOp::GetAll, ReadOp::Get, ReadOp::Cached}) {
+                for (WriteOp writeOp : {WriteOp::Update, WriteOp::Set}) {
+                    if (writers == 0 && writeOp == WriteOp::Set) {
+                        continue;  // same as Update without writers
+                    }
+                    const Result r = runScenario<Size>(opt, readers, writers, readOp, writeOp, overheadNs);
+                    std::printf("%7zu %7d %7d %-7s %-7s %10.1f %9.1f %9.1f %9.1f %11.5f\n",
+                                Size, readers, writers, name(readOp),
+                                writers == 0 ? "-" : name(writeOp),
+                                r.nsPerOp, r.p50, r.p99, r.p999, r.retriesPerOp);
+                    std::fflush(stdout);
+                }
+            }
+        }
+    }
+}
+
+template<typename V>
+std::vector<V> parseList(const char* text) {
+    std::vector<V> values;
+    const std::string s(text);
+    std::size_t pos = 0;
+    while (pos < s.size()) {
+        std::size_t next = s.find(',', pos);
+        if (next == std::string::npos) {
+            next = s.size();
+        }
+        values.push_back(static_cast<V>(std::strtoull(s.substr(pos, next - pos).c_str(), nullptr, 10)));
+        pos = next + 1;
+    }
+    return values;
+}
+
+bool wantSize(const Options& opt, std::size_t size) {
+    return std::find(opt.sizes.begin(), opt.sizes.end(), size) != opt.sizes.end();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--quick") {
+            opt.duration = std::chrono::milliseconds(20);
+            opt.readers = {1, 4};
+            opt.writers = {0, 1};
+            opt.sizes = {8, 40, 1024};
+        } else if (arg == "--duration-ms" && hasValue) {
+            opt.duration = std::chrono::milliseconds(std::atoi(argv[++i]));
+        } else if (arg == "--readers" && hasValue) {
+            opt.readers = parseList<int>(argv[++i]);
+        } else if (arg == "--writers" && hasValue) {
+            opt.writers = parseList<int>(argv[++i]);
+        } else if (arg == "--sizes" && hasValue) {
+            opt.sizes = parseList<std::size_t>(argv[++i]);
+        } else {
+            std::fprintf(stderr,
+                         "usage: %s [--quick] [--duration-ms N] [--readers 1,4,16,64] "
+                         "[--writers 0,1,4] [--sizes 8,40,64,256,1024,4096,16384]\n",
+                         argv[0]);
+            return 1;
+        }
+    }
+
+    const double overheadNs = clockOverheadNs();
+    std::printf("# hardware threads: %u, clock overhead: %.1f ns (subtracted from samples)\n",
+                std::thread::hardware_concurrency(), overheadNs);
+    std::printf("# layout: %s, sizeof(State) for 40 B config: %zu\n",
+                detail::cache_line_size > 1 ? "cache-line padded" : "packed",
+                sizeof(BenchConfigly<Payload<40>>::State));
+    std::printf("%7s %7s %7s %-7s %-7s %10s %9s %9s %9s %11s\n",
+                "size", "readers", "writers", "read", "write", "ns/op", "p50", "p99", "p999", "retries/op");
+
+    if (wantSize(opt, 8))     runSize<8>(opt, overheadNs);
+    if (wantSize(opt, 40))    runSize<40>(opt, overheadNs);
+    if (wantSize(opt, 64))    runSize<64>(opt, overheadNs);
+    if (wantSize(opt, 256))   runSize<256>(opt, overheadNs);
+    if (wantSize(opt, 1024))  runSize<1024>(opt, overheadNs);
+    if (wantSize(opt, 4096))  runSize<4096>(opt, overheadNs);
+    if (wantSize(opt, 16384)) runSize<16384>(opt, overheadNs);
+
+    return 0;
+}
@@ -7,15 +7,116 @@
 #include <utility>
 #include <cassert>
 #include <cstring>
+#include <cstdint>
+#include <tuple>
+#include <chrono>
+#include <limits>
+#include <algorithm>
+#include <new>
+
+#if !defined(CONFIGLY_NO_STD_THREAD)
+#include <thread>
+#endif
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+// Line size used to keep buffers and control words apart. GCC's
+// std::hardware_destructive_interference_size follows -mtune and warns when
+// used in headers, so GCC gets a per-architecture constant instead.
+#if !defined(CONFIGLY_CACHE_LINE_SIZE)
+#if defined(__cpp_lib_hardware_interference_size) && !(defined(__GNUC__) && !defined(__clang__))
+#define CONFIGLY_CACHE_LINE_SIZE std::hardware_destructive_interference_size
+#elif defined(__APPLE__) && defined(__aarch64__)
+#define CONFIGLY_CACHE_LINE_SIZE 128
+#else
+#define CONFIGLY_CACHE_LINE_SIZE 64
+#endif
+#endif
+
+// Largest T that tryModify() edits in a copy on the writer's stack before it
+// opens a buffer; a bigger T is edited in the opened buffer instead.
+#if !defined(CONFIGLY_STACK_EDIT_MAX)
+#define CONFIGLY_STACK_EDIT_MAX 256
+#endif
+
+// Makes a static that must be constant-initialized fail to compile otherwise
+// (C++20 constinit, or clang's attribute in C++17).
+#if defined(__cpp_constinit)
+#define CONFIGLY_CONSTINIT constinit
+#elif defined(__clang__)
+#define CONFIGLY_CONSTINIT [[clang::require_constant_initialization]]
+#else
+#define CONFIGLY_CONSTINIT
+#endif
+
+#if !defined(CONFIGLY_NO_PTHREAD) && defined(__has_include)
+#if __has_include(<pthread.h>)
+#define CONFIGLY_HAS_PTHREAD 1
+#include <pthread.h>
+#endif
+#endif
+
+#if !defined(CONFIGLY_NO_FUTEX) && defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/futex.h>) && __has_include(<sys/syscall.h>)
+#define CONFIGLY_HAS_FUTEX 1
+#include <climits>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CONFIGLY_HAS_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define CONFIGLY_HAS_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace configly {
+    /**
+     * @brief Set by CONFIGLY_OPAQUE(T): T is tracked as one field, never reflected.
+     */
+    template<typename T>
+    struct opaque : std::false_type {};
+}
+
+/**
+ * @brief Turns off field reflection for @p Type (e.g. for `bool on : 1` bit-fields,
+ *        which reflectable() cannot see). Use at global scope.
+ */
+#define CONFIGLY_OPAQUE(Type)                    \
+    template<>                                  \
+    struct configly::opaque<Type> : std::true_type {}
 
 namespace detail {
+#if defined(CONFIGLY_PACKED_LAYOUT)
+    // natural alignment only: saves RAM on small targets, allows false sharing
+    inline constexpr std::size_t cache_line_size = 1;
+#else
+    inline constexpr std::size_t cache_line_size = CONFIGLY_CACHE_LINE_SIZE;
+#endif
+
+    /**
+     * @brief Alignment that puts an object holding @p Ts on a cache line of its own
+     *        (never weaker than the natural alignment of @p Ts).
+     */
+    template<typename... Ts>
+    inline constexpr std::size_t line_align = std::max({cache_line_size, alignof(Ts)...});
+
     struct any_type {
         template<typename T>
         constexpr operator T() const noexcept;
     };
 
+    // Every argument is wrapped in its own braces so that brace elision cannot
+    // spread one argument over the elements of an array or nested aggregate.
     template<typename T, typename... Args>
-    constexpr auto is_brace_constructible(int) -> decltype(T{std::declval<Args>()...}, std::true_type{});
+    constexpr auto is_brace_constructible(int) -> decltype(T{{std::declval<Args>()}...}, std::true_type{});
     
     template<typename T, typename... Args>
     constexpr std::false_type is_brace_constructible(...);
@@ -34,338 +135,2651 @@ namespace detail {
 
     template<typename T, std::size_t N = 0>
     constexpr std::size_t count_fields() {
-        if constexpr (N > 64) {
-            return 0; // Sanity limit
-        } else if constexpr (count_fields_impl<T>(std::make_index_sequence<N>{}) == N) {
+        if constexpr (!std::is_aggregate<T>::value || N > 64) {
+            return 0; // Not reflectable / sanity limit
+        } else if constexpr (count_fields_impl<T>(std::make_index_sequence<N + 1>{}) != N + 1) {
+            // N initializers fit, N + 1 do not
             return N;
         } else {
             return count_fields<T, N + 1>();
         }
     }
-    
-    template<typename T>
-    constexpr std::size_t default_max_callbacks() {
-        constexpr std::size_t detected = count_fields<T>();
-        return detected > 0 ? detected : 16;
-    }
-}
 
-template<typename T, size_t MaxCallbacks = detail::default_max_callbacks<T>()>
-class Configly
-{
-    static_assert(std::is_trivially_copyable<T>::value,
-                  "Config struct T must be trivially copyable.");
-    static_assert(MaxCallbacks > 0 && MaxCallbacks <= 64,
-                  "MaxCallbacks must be between 1 and 64");
+    /**
+     * @brief Calls @p f with every top-level member of @p obj, in declaration order.
+     *
+     * T must be an aggregate without base classes. @p f may take bit-fields by
+     * value only.
+     */
+    template<std::size_t Count, typename T, typename F>
+    constexpr decltype(auto) with_fields(T& obj, F&& f) {
+#define CONFIGLY_DETAIL_TIE(N, ...) \
+        else if constexpr (Count == N) { auto& [__VA_ARGS__] = obj; return std::forward<F>(f)(__VA_ARGS__); }
 
-public:
-    static Configly& instance() {
-        static Configly i;
-        return i;
+        if constexpr (Count == 0) { return std::forward<F>(f)(); }
+        CONFIGLY_DETAIL_TIE(1, f0)
+        CONFIGLY_DETAIL_TIE(2, f0, f1)
+        CONFIGLY_DETAIL_TIE(3, f0, f1, f2)
+        CONFIGLY_DETAIL_TIE(4, f0, f1, f2, f3)
+        CONFIGLY_DETAIL_TIE(5, f0, f1, f2, f3, f4)
+        CONFIGLY_DETAIL_TIE(6, f0, f1, f2, f3, f4, f5)
+        CONFIGLY_DETAIL_TIE(7, f0, f1, f2, f3, f4, f5, f6)
+        CONFIGLY_DETAIL_TIE(8, f0, f1, f2, f3, f4, f5, f6, f7)
+        CONFIGLY_DETAIL_TIE(9, f0, f1, f2, f3, f4, f5, f6, f7, f8)
+        CONFIGLY_DETAIL_TIE(10, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9)
+        CONFIGLY_DETAIL_TIE(11, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10)
+        CONFIGLY_DETAIL_TIE(12, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11)
+        CONFIGLY_DETAIL_TIE(13, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12)
+        CONFIGLY_DETAIL_TIE(14, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13)
+        CONFIGLY_DETAIL_TIE(15, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14)
+        CONFIGLY_DETAIL_TIE(16, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15)
+        CONFIGLY_DETAIL_TIE(17, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16)
+        CONFIGLY_DETAIL_TIE(18, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17)
+        CONFIGLY_DETAIL_TIE(19, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18)
+        CONFIGLY_DETAIL_TIE(20, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19)
+        CONFIGLY_DETAIL_TIE(21, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20)
+        CONFIGLY_DETAIL_TIE(22, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21)
+        CONFIGLY_DETAIL_TIE(23, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22)
+        CONFIGLY_DETAIL_TIE(24, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23)
+        CONFIGLY_DETAIL_TIE(25, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24)
+        CONFIGLY_DETAIL_TIE(26, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25)
+        CONFIGLY_DETAIL_TIE(27, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26)
+        CONFIGLY_DETAIL_TIE(28, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27)
+        CONFIGLY_DETAIL_TIE(29, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28)
+        CONFIGLY_DETAIL_TIE(30, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29)
+        CONFIGLY_DETAIL_TIE(31, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30)
+        CONFIGLY_DETAIL_TIE(32, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31)
+        CONFIGLY_DETAIL_TIE(33, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32)
+        CONFIGLY_DETAIL_TIE(34, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33)
+        CONFIGLY_DETAIL_TIE(35, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34)
+        CONFIGLY_DETAIL_TIE(36, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35)
+        CONFIGLY_DETAIL_TIE(37, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36)
+        CONFIGLY_DETAIL_TIE(38, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37)
+        CONFIGLY_DETAIL_TIE(39, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38)
+        CONFIGLY_DETAIL_TIE(40, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39)
+        CONFIGLY_DETAIL_TIE(41, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39, f40)
+        CONFIGLY_DETAIL_TIE(42, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39, f40, f41)
+        CONFIGLY_DETAIL_TIE(43, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39, f40, f41, f42)
+        CONFIGLY_DETAIL_TIE(44, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39, f40, f41, f42, f43)
+        CONFIGLY_DETAIL_TIE(45, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39, f40, f41, f42, f43, f44)
+        CONFIGLY_DETAIL_TIE(46, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39, f40, f41, f42, f43, f44, f45)
+        CONFIGLY_DETAIL_TIE(47, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39, f40, f41, f42, f43, f44, f45, f46)
+        CONFIGLY_DETAIL_TIE(48, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39, f40, f41, f42, f43, f44, f45, f46, f47)
+        CONFIGLY_DETAIL_TIE(49, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39, f40, f41, f42, f43, f44, f45, f46, f47, f48)
+        CONFIGLY_DETAIL_TIE(50, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39, f40, f41, f42, f43, f44, f45, f46, f47, f48, f49)
+        CONFIGLY_DETAIL_TIE(51, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39, f40, f41, f42, f43, f44, f45, f46, f47, f48, f49, f50)
+        CONFIGLY_DETAIL_TIE(52, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39, f40, f41, f42, f43, f44, f45, f46, f47, f48, f49, f50, f51)
+        CONFIGLY_DETAIL_TIE(53, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39, f40, f41, f42, f43, f44, f45, f46, f47, f48, f49, f50, f51, f52)
+        CONFIGLY_DETAIL_TIE(54, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39, f40, f41, f42, f43, f44, f45, f46, f47, f48, f49, f50, f51, f52, f53)
+        CONFIGLY_DETAIL_TIE(55, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39, f40, f41, f42, f43, f44, f45, f46, f47, f48, f49, f50, f51, f52, f53, f54)
+        CONFIGLY_DETAIL_TIE(56, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39, f40, f41, f42, f43, f44, f45, f46, f47, f48, f49, f50, f51, f52, f53, f54, f55)
+        CONFIGLY_DETAIL_TIE(57, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39, f40, f41, f42, f43, f44, f45, f46, f47, f48, f49, f50, f51, f52, f53, f54, f55, f56)
+        CONFIGLY_DETAIL_TIE(58, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39, f40, f41, f42, f43, f44, f45, f46, f47, f48, f49, f50, f51, f52, f53, f54, f55, f56, f57)
+        CONFIGLY_DETAIL_TIE(59, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39, f40, f41, f42, f43, f44, f45, f46, f47, f48, f49, f50, f51, f52, f53, f54, f55, f56, f57, f58)
+        CONFIGLY_DETAIL_TIE(60, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39, f40, f41, f42, f43, f44, f45, f46, f47, f48, f49, f50, f51, f52, f53, f54, f55, f56, f57, f58, f59)
+        CONFIGLY_DETAIL_TIE(61, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39, f40, f41, f42, f43, f44, f45, f46, f47, f48, f49, f50, f51, f52, f53, f54, f55, f56, f57, f58, f59, f60)
+        CONFIGLY_DETAIL_TIE(62, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39, f40, f41, f42, f43, f44, f45, f46, f47, f48, f49, f50, f51, f52, f53, f54, f55, f56, f57, f58, f59, f60, f61)
+        CONFIGLY_DETAIL_TIE(63, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39, f40, f41, f42, f43, f44, f45, f46, f47, f48, f49, f50, f51, f52, f53, f54, f55, f56, f57, f58, f59, f60, f61, f62)
+        CONFIGLY_DETAIL_TIE(64, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39, f40, f41, f42, f43, f44, f45, f46, f47, f48, f49, f50, f51, f52, f53, f54, f55, f56, f57, f58, f59, f60, f61, f62, f63)
+#undef CONFIGLY_DETAIL_TIE
     }
 
-    Configly(const Configly&) = delete;
-    Configly& operator=(const Configly&) = delete;
-    Configly(Configly&&) = delete;
-    Configly& operator=(Configly&&) = delete;
+    /**
+     * @brief Binds every top-level member of @p obj, in declaration order, into a tuple of references.
+     *
+     * Only instantiated for configs that pass reflectable() (and by the opt-in
+     * headers, which document that they need it).
+     */
+    template<std::size_t Count, typename T>
+    constexpr auto tie_fields(T& obj) {
+        return with_fields<Count>(obj, [](auto&... fields) { return std::tie(fields...); });
+    }
 
-    void setDefault(const T& defaultConfig) {
-        m_defaultConfig = defaultConfig;
+    // converts only to the proper bases of T, so T{any_base_of<T>{}} compiles
+    // iff the first aggregate element of T is a base class
+    template<typename T>
+    struct any_base_of {
+        template<typename U,
+                 typename = std::enable_if_t<std::is_base_of<U, T>::value && !std::is_same<U, T>::value>>
+        constexpr operator U() const noexcept;
+    };
+
+    template<typename T>
+    constexpr auto has_base_impl(int) -> decltype(T{std::declval<any_base_of<T>>()}, std::true_type{});
 
-        // init both buffers with seq = 0 (even → stable) and same data
-        m_buffers[0].seq.store(0, std::memory_order_relaxed);
-        m_buffers[0].data = defaultConfig;
+    template<typename T>
+    constexpr std::false_type has_base_impl(...);
 
-        m_buffers[1].seq.store(0, std::memory_order_relaxed);
-        m_buffers[1].data = defaultConfig;
+    template<typename T, typename = void>
+    struct constant_default : std::false_type {};
 
-        m_activeIndex.store(0, std::memory_order_release);
-    }
+    template<typename T>
+    struct constant_default<T, std::enable_if_t<(static_cast<void>(T{}), true)>> : std::true_type {};
 
-    [[nodiscard]] const T& getDefault() const {
-        return m_defaultConfig;
+    // a value every ordinary field of type U keeps, and a narrow bit-field cannot
+    template<typename U>
+    constexpr U probe_value() noexcept {
+        if constexpr (std::is_integral<U>::value && !std::is_same<U, bool>::value) {
+            return std::numeric_limits<U>::max();
+        } else if constexpr (std::is_enum<U>::value) {
+            using Under = std::underlying_type_t<U>;
+            // scoped enums have a fixed underlying type, so every value of it is valid
+            if constexpr (!std::is_convertible<U, Under>::value) {
+                return static_cast<U>(std::numeric_limits<Under>::max());
+            } else {
+                return U{};
+            }
+        } else {
+            return U{};
+        }
     }
 
-    /**
-     * @brief Atomically retrieves a consistent snapshot of the entire current configuration.
-     */
-    void getAll(T& outConfig) const {
-        for (;;) {
-            int idx = m_activeIndex.load(std::memory_order_acquire);
-            const Buffer& buf = m_buffers[idx];
+    struct any_probe {
+        template<typename U>
+        constexpr operator U() const noexcept { return probe_value<U>(); }
+    };
 
-            // read start sequence
-            std::uint64_t start = buf.seq.load(std::memory_order_acquire);
-            if (start & 1u) {
-                // writer in progress on this buffer
-                continue;
-            }
+    template<typename F>
+    constexpr bool keeps_probe(const F& field) {
+        if constexpr (std::is_integral<F>::value || std::is_enum<F>::value) {
+            return field == probe_value<F>();
+        } else {
+            return true;
+        }
+    }
 
-            // copy data
-            T temp = buf.data;
+    template<typename... Fs>
+    struct type_list {};
 
-            // make sure we see any writes to data before re-reading seq
-            std::atomic_thread_fence(std::memory_order_acquire);
+    // field types as seen by value: bit-fields as their type, arrays decayed
+    struct field_values {
+        template<typename... Fs>
+        constexpr type_list<Fs...> operator()(Fs...) const { return {}; }
+    };
 
-            // read end sequence
-            std::uint64_t end = buf.seq.load(std::memory_order_acquire);
+    template<typename T>
+    using field_value_types = decltype(with_fields<count_fields<T>()>(std::declval<T&>(), field_values{}));
 
-            // success iff same and even
-            if (start == end && !(end & 1u)) {
-                outConfig = temp;
-                return;
-            }
-            // else retry
+    // class fields get a default one, so no initializer_list constructor is picked
+    template<typename F>
+    constexpr auto probe_for() {
+        if constexpr (std::is_class<F>::value) {
+            return F{};
+        } else {
+            return any_probe{};
         }
     }
 
-    template<typename MemberPtr>
-    [[nodiscard]] auto get(MemberPtr member) const {
-        T tempConfig;
-        getAll(tempConfig);
-        return tempConfig.*member;
+    template<typename T, typename... Fs>
+    constexpr bool probe_survives(type_list<Fs...>) {
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Woverflow"  // truncating a bit-field here is the point
+#endif
+        const T probe{{probe_for<Fs>()}...};
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+        // by value: that is the one way to touch a bit-field through a binding
+        return with_fields<sizeof...(Fs)>(probe, [](auto... fields) { return (keeps_probe(fields) && ...); });
     }
-    
+
+    template<typename T, typename = void>
+    struct no_narrow_bitfields : std::false_type {};
+
+    template<typename T>
+    struct no_narrow_bitfields<T, std::enable_if_t<probe_survives<T>(field_value_types<T>{})>>
+        : std::true_type {};
+
     /**
-     * @brief Atomically updates the entire configuration from an in-memory struct.
+     * @brief True iff the field reflection (tie_fields, field_layout, field_index)
+     *        works on T.
+     *
+     * That means T is an aggregate with fields and without base classes, `T{}` is
+     * a constant expression, and T has no bit-field narrower than its type. A
+     * bit-field as wide as its type (`bool on : 1`, `int x : 32`) looks like an
+     * ordinary field here; declare such configs with CONFIGLY_OPAQUE(T).
+     * Configs that fail get whole-struct change tracking instead.
+     */
+    template<typename T>
+    constexpr bool reflectable() {
+        if constexpr (!std::is_aggregate<T>::value || count_fields<T>() == 0 || configly::opaque<T>::value) {
+            return false;
+        } else if constexpr (decltype(has_base_impl<T>(0))::value || !constant_default<T>::value) {
+            return false;
+        } else {
+            return no_narrow_bitfields<T>::value;
+        }
+    }
+
+    /**
+     * @brief Number of fields the core tracks separately; 0 = T is one opaque field.
      */
-    void update(const T& new_config) {
-        // serialize writers
-        while (m_writeLock.test_and_set(std::memory_order_acquire)) {
-            // spin
+    template<typename T>
+    constexpr std::size_t reflected_fields() {
+        if constexpr (reflectable<T>()) {
+            return count_fields<T>();
+        } else {
+            return 0;
         }
+    }
 
-        int active_idx = m_activeIndex.load(std::memory_order_relaxed);
-        int inactive_idx = 1 - active_idx;
+    template<typename T>
+    inline constexpr T reflection_object{};
 
-        T old_config = m_buffers[active_idx].data;
+    template<typename Fields, typename Ptr, std::size_t... Is>
+    constexpr std::size_t find_field(const Fields& fields, const Ptr* ptr, std::index_sequence<Is...>) {
+        std::size_t index = sizeof...(Is);
+        ((static_cast<const void*>(&std::get<Is>(fields)) == static_cast<const void*>(ptr)
+              ? (index = Is, true) : false) || ...);
+        return index;
+    }
 
-        // write to inactive buffer using seq protocol
-        Buffer& target = m_buffers[inactive_idx];
+    /**
+     * @brief Declaration-order index of @p Member inside T, resolved at compile time.
+     */
+    template<typename T, auto Member>
+    constexpr std::size_t field_index() {
+        constexpr std::size_t count = count_fields<T>();
+        return find_field(tie_fields<count>(reflection_object<T>),
+                          &(reflection_object<T>.*Member),
+                          std::make_index_sequence<count>{});
+    }
+    
+    struct field_span {
+        std::size_t offset;
+        std::size_t size;
+    };
 
-        // start write: make seq odd
-        std::uint64_t seq = target.seq.load(std::memory_order_relaxed);
-        target.seq.store(seq + 1, std::memory_order_release);   // odd → writer active
+    // T overlaid with its own bytes, so a member's offset is an address compare
+    template<typename T>
+    union offset_probe {
+        T object;
+        unsigned char bytes[sizeof(T)];
 
-        // actual data write
-        target.data = new_config;
+        constexpr offset_probe() : object{} {}
+    };
 
-        // end write: make seq even
-        target.seq.store(seq + 2, std::memory_order_release);   // even → stable
+    template<typename T>
+    inline constexpr offset_probe<T> offset_probe_object{};
 
-        // publish
-        m_activeIndex.store(inactive_idx, std::memory_order_release);
+    /**
+     * @brief Byte offset of @p Member inside T, as a constant expression.
+     *
+     * Only for reflectable() T. Members sit at multiples of their alignment, so
+     * that is tried first; a packed T falls back to every byte.
+     */
+    template<typename T, auto Member>
+    constexpr std::size_t member_offset() {
+        using M = std::remove_reference_t<decltype(offset_probe_object<T>.object.*Member)>;
+        const void* target = &(offset_probe_object<T>.object.*Member);
+        for (std::size_t step : {alignof(M), std::size_t{1}}) {
+            for (std::size_t at = 0; at < sizeof(T); at += step) {
+                if (target == static_cast<const void*>(&offset_probe_object<T>.bytes[at])) {
+                    return at;
+                }
+            }
+        }
+        return sizeof(T);
+    }
 
-        m_writeLock.clear(std::memory_order_release);
+    template<typename T, typename Fields, std::size_t... Is>
+    auto make_field_layout(const Fields& fields, std::index_sequence<Is...>) {
+        std::array<field_span, sizeof...(Is)> layout{};
+        const char* base = reinterpret_cast<const char*>(&reflection_object<T>);
+        ((layout[Is] = {static_cast<std::size_t>(
+                            reinterpret_cast<const char*>(&std::get<Is>(fields)) - base),
+                        sizeof(std::get<Is>(fields))}), ...);
+        return layout;
+    }
 
-        // callbacks based on old vs new
-        triggerCallbacksForChanges(old_config, m_buffers[inactive_idx].data);
+    template<typename T>
+    auto make_field_layout() {
+        constexpr std::size_t count = reflected_fields<T>();
+        if constexpr (count > 0) {
+            return make_field_layout<T>(tie_fields<count>(reflection_object<T>),
+                                        std::make_index_sequence<count>{});
+        } else {
+            // not reflectable: the whole struct is one field
+            return std::array<field_span, 1>{{{0, sizeof(T)}}};
+        }
     }
 
     /**
-     * @brief Set a specific member value and trigger its callback if registered.
+     * @brief Offset and size of every field of T, in declaration order.
      */
-    template<typename MemberPtr, typename ValueType>
-    void set(MemberPtr member, ValueType&& value) {
-        static_assert(std::is_member_object_pointer<MemberPtr>::value,
-                      "Member pointer required");
-
-        while (m_writeLock.test_and_set(std::memory_order_acquire)) {
-            // spin
-        }
+    template<typename T>
+    inline const auto field_layout = make_field_layout<T>();
 
-        int active_idx = m_activeIndex.load(std::memory_order_relaxed);
-        int inactive_idx = 1 - active_idx;
+    /**
+     * @brief Type of the I-th field of T, in declaration order.
+     */
+    template<typename T, std::size_t I>
+    using field_type_t = std::remove_cv_t<std::remove_reference_t<
+        decltype(std::get<I>(tie_fields<count_fields<T>()>(std::declval<T&>())))>>;
 
-        auto oldValue = m_buffers[active_idx].data.*member;
+    template<typename T, typename MemberPtr>
+    using member_type_t = std::remove_cv_t<std::remove_reference_t<
+        decltype(std::declval<const T&>().*std::declval<MemberPtr>())>>;
 
-        // start write on inactive
-        Buffer& target = m_buffers[inactive_idx];
-        std::uint64_t seq = target.seq.load(std::memory_order_relaxed);
-        target.seq.store(seq + 1, std::memory_order_release);   // odd
+    // fields that can copy just their live bytes, e.g. configly::fixed_string
+    template<typename F, typename = void>
+    struct has_used_copy : std::false_type {};
 
-        // copy current config then modify field
-        target.data = m_buffers[active_idx].data;
-        target.data.*member = std::forward<ValueType>(value);
+    template<typename F>
+    struct has_used_copy<F, std::void_t<decltype(std::declval<F&>().copy_used_from(std::declval<const F&>()))>>
+        : std::true_type {};
 
-        // end write
-        target.seq.store(seq + 2, std::memory_order_release);   // even
+    template<typename T, std::size_t... Is>
+    constexpr bool any_used_copy(std::index_sequence<Is...>) {
+        return (has_used_copy<field_type_t<T, Is>>::value || ...);
+    }
 
-        // publish
-        m_activeIndex.store(inactive_idx, std::memory_order_release);
+    template<typename T>
+    constexpr bool has_trimmed_fields() {
+        if constexpr (reflected_fields<T>() > 0) {
+            return any_used_copy<T>(std::make_index_sequence<count_fields<T>()>{});
+        } else {
+            return false;
+        }
+    }
 
-        m_writeLock.clear(std::memory_order_release);
+    template<typename T, std::size_t... Is>
+    void copy_trimmed(T& dst, const T& src, std::index_sequence<Is...>) {
+        constexpr std::size_t count = sizeof...(Is);
+        const auto& layout = field_layout<T>;
+        auto to = tie_fields<count>(dst);
+        const auto from = tie_fields<count>(src);
+        char* d = reinterpret_cast<char*>(&dst);
+        const char* s = reinterpret_cast<const char*>(&src);
+        ([&] {
+            const std::size_t begin = layout[Is].offset;
+            const std::size_t end = Is + 1 < count ? layout[Is + 1].offset : sizeof(T);
+            if constexpr (has_used_copy<field_type_t<T, Is>>::value) {
+                std::get<Is>(to).copy_used_from(std::get<Is>(from));
+                // trailing padding still goes along, so diffs never see stale bytes
+                const std::size_t used = begin + layout[Is].size;
+                std::memcpy(d + used, s + used, end - used);
+            } else {
+                std::memcpy(d + begin, s + begin, end - begin);
+            }
+        }(), ...);
+    }
 
-        // trigger callback if actually changed
-        if (!(oldValue == (m_buffers[inactive_idx].data.*member))) {
-            const size_t offset = calculateOffset(member);
-            triggerCallback(offset, &(m_buffers[inactive_idx].data.*member));
+    /**
+     * @brief dst = src, except that fields with copy_used_from() (fixed_string,
+     *        fixed_vector) only copy their live part.
+     *
+     * Used for every buffer copy, so a mostly empty fixed_string<256> costs its
+     * length rather than 256 bytes. Plain configs, and any T that reflectable()
+     * rejects (bit-fields, base classes), compile to a plain assignment.
+     */
+    template<typename T>
+    void copy_config(T& dst, const T& src) {
+        if constexpr (has_trimmed_fields<T>()) {
+            copy_trimmed(dst, src, std::make_index_sequence<count_fields<T>()>{});
+        } else {
+            dst = src;
         }
     }
 
-    template<typename MemberPtr>
-    Configly& onChange(
-        MemberPtr member,
-        void (*user_callback)(const std::remove_reference_t<decltype(std::declval<T>().*member)>&, void*),
-        void* user_context = nullptr) {
-        
-        static_assert(std::is_member_object_pointer<MemberPtr>::value,
-                      "Member pointer required");
-
-        using MemberType = std::remove_reference_t<decltype(std::declval<T>().*member)>;
+    /**
+     * @brief Tells the CPU we are busy-waiting (pause / yield hint).
+     */
+    inline void cpu_relax() noexcept {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        _mm_pause();
+#elif defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__) || (defined(__arm__) && defined(__ARM_ARCH) && __ARM_ARCH >= 7)
+        __asm__ __volatile__("yield");
+#endif
+    }
 
-        const size_t offset = calculateOffset(member);
-        assert(offset < sizeof(T) && "Invalid member offset");
+    /**
+     * @brief Gives the rest of the time slice away, if the platform has threads.
+     *        Define CONFIGLY_NO_STD_THREAD on targets without <thread>.
+     */
+    inline void yield_thread() noexcept {
+#if !defined(CONFIGLY_NO_STD_THREAD)
+        std::this_thread::yield();
+#else
+        cpu_relax();
+#endif
+    }
 
-        for (size_t i = 0; i < m_callbackCount; ++i) {
-            if (m_callbacks[i].memberOffset == offset) {
-                m_callbacks[i].originalCallback = reinterpret_cast<void*>(user_callback);
-                m_callbacks[i].userData = user_context;
-                m_callbacks[i].thunk = &callbackThunk<MemberType>;
-                return *this;
-            }
-        }
+#if defined(CONFIGLY_HAS_FUTEX)
+    // the futex word is the low half of the 64-bit version counter
+    inline const std::uint32_t* futex_word(const std::atomic<std::uint64_t>& counter) noexcept {
+        static_assert(sizeof(std::atomic<std::uint64_t>) == sizeof(std::uint64_t), "futex needs a plain 64-bit word");
+        const auto* halves = reinterpret_cast<const std::uint32_t*>(&counter);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        return halves + 1;
+#else
+        return halves;
+#endif
+    }
 
-        assert(m_callbackCount < MaxCallbacks && "Exceeded maximum number of callbacks!");
-        if (m_callbackCount >= MaxCallbacks) {
-            return *this;
+    /**
+     * @brief Sleeps while @p counter still holds @p expected, for at most
+     *        @p timeoutNs (negative: no limit). May return early or spuriously.
+     *
+     * @p sleepers counts the threads parked on @p counter; it lives next to it,
+     * so with @p shared set a writer in another process wakes them too.
+     */
+    inline void futex_wait(const std::atomic<std::uint64_t>& counter, std::atomic<std::uint32_t>& sleepers,
+                           std::uint64_t expected, std::int64_t timeoutNs, bool shared) noexcept {
+        timespec timeout{};
+        if (timeoutNs >= 0) {
+            timeout.tv_sec = static_cast<std::time_t>(timeoutNs / 1000000000);
+            timeout.tv_nsec = static_cast<long>(timeoutNs % 1000000000);
         }
-
-        auto& slot = m_callbacks[m_callbackCount];
-        slot.memberOffset = offset;
-        slot.originalCallback = reinterpret_cast<void*>(user_callback);
-        slot.userData = user_context;
-        slot.memberSize = sizeof(m_defaultConfig.*member);
-        slot.thunk = &callbackThunk<MemberType>;
-        
-        ++m_callbackCount;
-        
-        return *this;
+        // the kernel re-checks the word after this increment, so a writer that
+        // saw no sleepers has already changed it
+        sleepers.fetch_add(1, std::memory_order_seq_cst);
+        syscall(SYS_futex, futex_word(counter), shared ? FUTEX_WAIT : FUTEX_WAIT_PRIVATE,
+                static_cast<std::uint32_t>(expected), timeoutNs >= 0 ? &timeout : nullptr, nullptr, 0);
+        sleepers.fetch_sub(1, std::memory_order_relaxed);
     }
 
-    template<typename MemberPtr>
-    void removeCallback(MemberPtr member) {
-        const size_t offset = calculateOffset(member);
-        for (size_t i = 0; i < m_callbackCount; ++i) {
-            if (m_callbacks[i].memberOffset == offset) {
-                m_callbacks[i].thunk = nullptr;
-                return;
-            }
+    // call after storing the new counter value
+    inline void futex_wake_all(const std::atomic<std::uint64_t>& counter, const std::atomic<std::uint32_t>& sleepers,
+                               bool shared) noexcept {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleepers.load(std::memory_order_relaxed) != 0) {
+            syscall(SYS_futex, futex_word(counter), shared ? FUTEX_WAKE : FUTEX_WAKE_PRIVATE, INT_MAX,
+                    nullptr, nullptr, 0);
         }
     }
+#endif
 
-    void setSaveFunction(bool (*fn)(const T&)) { 
-        m_saveFunction = fn; 
-    }
-    
-    void setLoadFunction(bool (*fn)(T&)) { 
-        m_loadUserConfig = fn; 
+    inline unsigned ctz32(std::uint32_t x) noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long index;
+        _BitScanForward(&index, x);
+        return static_cast<unsigned>(index);
+#else
+        return static_cast<unsigned>(__builtin_ctz(x));
+#endif
     }
 
-    [[nodiscard]] bool save() const {
-        if (!m_saveFunction) return false;
-        T tempConfig;
-        getAll(tempConfig);
-        return m_saveFunction(tempConfig);
+    inline unsigned ctz64(std::uint64_t x) noexcept {
+#if defined(_MSC_VER) && !defined(__clang__) && defined(_WIN64)
+        unsigned long index;
+        _BitScanForward64(&index, x);
+        return static_cast<unsigned>(index);
+#elif defined(_MSC_VER) && !defined(__clang__)
+        const auto low = static_cast<std::uint32_t>(x);
+        return low != 0 ? ctz32(low) : 32 + ctz32(static_cast<std::uint32_t>(x >> 32));
+#else
+        return static_cast<unsigned>(__builtin_ctzll(x));
+#endif
     }
 
-    [[nodiscard]] bool load() {
-        if (!m_loadUserConfig) return false;
-        T tempConfig;
-        if (m_loadUserConfig(tempConfig)) {
-            update(tempConfig);
-            return true;
+    /**
+     * @brief Offset of the first byte in [from, size) where @p a and @p b differ,
+     *        or @p size if the range is identical.
+     *
+     * Compares 16 bytes per step with SSE2/NEON, 8 bytes per step otherwise.
+     */
+    inline std::size_t first_difference(const void* a, const void* b,
+                                        std::size_t from, std::size_t size) noexcept {
+        const unsigned char* pa = static_cast<const unsigned char*>(a);
+        const unsigned char* pb = static_cast<const unsigned char*>(b);
+        std::size_t i = from;
+
+#if defined(CONFIGLY_HAS_SSE2)
+        for (; i + 16 <= size; i += 16) {
+            const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pa + i));
+            const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pb + i));
+            const std::uint32_t equal = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)));
+            if (equal != 0xFFFFu) {
+                return i + ctz32(~equal & 0xFFFFu);
+            }
         }
-        return false;
+#elif defined(CONFIGLY_HAS_NEON)
+        for (; i + 16 <= size; i += 16) {
+            const uint8x16_t equal = vceqq_u8(vld1q_u8(pa + i), vld1q_u8(pb + i));
+            const uint64x2_t lanes = vreinterpretq_u64_u8(equal);
+            if ((vgetq_lane_u64(lanes, 0) & vgetq_lane_u64(lanes, 1)) != ~std::uint64_t{0}) {
+                break;  // the byte loop below pins down the exact offset
+            }
+        }
+#else
+        for (; i + 8 <= size; i += 8) {
+            std::uint64_t wa, wb;
+            std::memcpy(&wa, pa + i, sizeof(wa));
+            std::memcpy(&wb, pb + i, sizeof(wb));
+            if (wa != wb) {
+                break;  // the byte loop below pins down the exact offset
+            }
+        }
+#endif
+        for (; i < size; ++i) {
+            if (pa[i] != pb[i]) {
+                return i;
+            }
+        }
+        return size;
     }
 
-    void restoreDefaults() {
-        update(m_defaultConfig);
+    // base-from-member holder, so the state exists before the Configly using it
+    template<typename State>
+    struct owned_state {
+        State m_ownedState;
+    };
+
+    // std::array::fill() is not constexpr before C++20
+    template<std::size_t N>
+    constexpr std::array<std::uint8_t, N> filled_array(std::uint8_t value) {
+        std::array<std::uint8_t, N> a{};
+        for (std::size_t i = 0; i < N; ++i) {
+            a[i] = value;
+        }
+        return a;
     }
 
-    template<typename MemberPtr>
-    void restoreDefault(MemberPtr member) {
-        set(member, m_defaultConfig.*member);
+    template<typename T>
+    constexpr std::size_t default_max_callbacks() {
+        constexpr std::size_t detected = count_fields<T>();
+        return detected > 0 ? detected : 16;
     }
+}
 
-private:
-    struct Buffer {
-        std::atomic<std::uint64_t> seq;
-        T data;
+namespace configly {
+    /**
+     * @brief Where change callbacks run.
+     */
+    enum class DispatchMode {
+        Immediate,  ///< on the writer's thread, right after publish (default)
+        Deferred    ///< queued; run by whoever calls dispatchPending()
     };
 
-    Configly()
-        : m_activeIndex(0),
-          m_callbacks{},
-          m_callbackCount(0)
-    {
-        m_writeLock.clear(std::memory_order_relaxed);
+    /**
+     * @brief Optional OS hooks used by waitForChange(), e.g. a FreeRTOS event group.
+     *
+     * notify() is called after every publish. wait() blocks the caller until a
+     * notify() or until @p timeoutUs elapsed (kWaitForever = no timeout) and
+     * must not lose a notify() issued between the version check and the call
+     * (event group bits, semaphores and futexes all satisfy that).
+     */
+    struct WaitHooks {
+        static constexpr std::uint64_t kWaitForever = std::numeric_limits<std::uint64_t>::max();
 
-        // make buffers initially valid
-        m_buffers[0].seq.store(0, std::memory_order_relaxed);
-        m_buffers[1].seq.store(0, std::memory_order_relaxed);
-    }
+        void (*wait)(void* context, std::uint64_t timeoutUs) = nullptr;
+        void (*notify)(void* context) = nullptr;
+        void* context = nullptr;
+    };
 
-    ~Configly() = default;
+    /**
+     * @brief Counter values returned by Configly::stats().
+     */
+    struct StatsSnapshot {
+        std::uint64_t readRetries = 0;    ///< reads redone because the buffer changed during the copy
+        std::uint64_t oddSeqSpins = 0;    ///< reads that found a writer active on the buffer
+        std::uint64_t lockSpins = 0;      ///< writer lock spin iterations
+        std::uint64_t updates = 0;        ///< update() / modify() calls
+        std::uint64_t sets = 0;           ///< set() calls
+        std::uint64_t skippedPublishes = 0;  ///< writes that changed no byte and were not published
+        std::uint64_t rejectedWrites = 0;    ///< writes refused by configly::schema<T>
+        std::uint64_t callbacks = 0;      ///< callback invocations
+        std::uint64_t callbackNanos = 0;  ///< time spent inside callbacks
+    };
 
-    template<typename MemberPtr>
-    [[nodiscard]] constexpr size_t calculateOffset(MemberPtr member) const {
-        const T temp_object{};
-        return reinterpret_cast<const char*>(&(temp_object.*member))
-               - reinterpret_cast<const char*>(&temp_object);
-    }
+    /**
+     * @brief Default stats policy: every hook is empty and compiles away.
+     */
+    struct NoStats {
+        static constexpr bool kEnabled = false;
 
-    void triggerCallback(size_t offset, const void* newValue) {
-        for (size_t i = 0; i < m_callbackCount; ++i) {
-            if (m_callbacks[i].memberOffset == offset && m_callbacks[i].thunk) {
-                m_callbacks[i].thunk(newValue, &m_callbacks[i]);
-                return;
-            }
+        void onReadRetry() noexcept {}
+        void onOddSeq() noexcept {}
+        void onLockSpins(std::uint64_t) noexcept {}
+        void onUpdate() noexcept {}
+        void onSet() noexcept {}
+        void onSkippedPublish() noexcept {}
+        void onRejectedWrite() noexcept {}
+        void onCallback(std::uint64_t) noexcept {}
+        [[nodiscard]] StatsSnapshot snapshot() const noexcept { return {}; }
+    };
+
+    /**
+     * @brief Relaxed per-instance counters for telemetry.
+     *
+     * Reader-side and writer-side counters live on separate cache lines, and
+     * both away from the buffers, so counting adds no false sharing to the
+     * read path.
+     */
+    class AtomicStats {
+    public:
+        static constexpr bool kEnabled = true;
+
+        void onReadRetry() noexcept { m_reader.retries.fetch_add(1, std::memory_order_relaxed); }
+        void onOddSeq() noexcept { m_reader.oddSeqSpins.fetch_add(1, std::memory_order_relaxed); }
+        void onLockSpins(std::uint64_t n) noexcept { m_writer.lockSpins.fetch_add(n, std::memory_order_relaxed); }
+        void onUpdate() noexcept { m_writer.updates.fetch_add(1, std::memory_order_relaxed); }
+        void onSet() noexcept { m_writer.sets.fetch_add(1, std::memory_order_relaxed); }
+        void onSkippedPublish() noexcept { m_writer.skipped.fetch_add(1, std::memory_order_relaxed); }
+        void onRejectedWrite() noexcept { m_writer.rejected.fetch_add(1, std::memory_order_relaxed); }
+        void onCallback(std::uint64_t nanos) noexcept {
+            m_writer.callbacks.fetch_add(1, std::memory_order_relaxed);
+            m_writer.callbackNanos.fetch_add(nanos, std::memory_order_relaxed);
         }
-    }
 
-    void triggerCallbacksForChanges(const T& oldConfig, const T& newConfig) {
-        for (size_t i = 0; i < m_callbackCount; ++i) {
-            auto& slot = m_callbacks[i];
-            if (slot.thunk) {
-                const char* oldPtr = reinterpret_cast<const char*>(&oldConfig) + slot.memberOffset;
-                const char* newPtr = reinterpret_cast<const char*>(&newConfig) + slot.memberOffset;
-                
-                if (std::memcmp(oldPtr, newPtr, slot.memberSize) != 0) {
-                    slot.thunk(newPtr, &slot);
-                }
+        [[nodiscard]] StatsSnapshot snapshot() const noexcept {
+            StatsSnapshot s;
+            s.readRetries = m_reader.retries.load(std::memory_order_relaxed);
+            s.oddSeqSpins = m_reader.oddSeqSpins.load(std::memory_order_relaxed);
+            s.lockSpins = m_writer.lockSpins.load(std::memory_order_relaxed);
+            s.updates = m_writer.updates.load(std::memory_order_relaxed);
+            s.sets = m_writer.sets.load(std::memory_order_relaxed);
+            s.skippedPublishes = m_writer.skipped.load(std::memory_order_relaxed);
+            s.rejectedWrites = m_writer.rejected.load(std::memory_order_relaxed);
+            s.callbacks = m_writer.callbacks.load(std::memory_order_relaxed);
+            s.callbackNanos = m_writer.callbackNanos.load(std::memory_order_relaxed);
+            return s;
+        }
+
+    private:
+        struct alignas(detail::line_align<std::atomic<std::uint64_t>>) ReaderCounters {
+            std::atomic<std::uint64_t> retries{0};
+            std::atomic<std::uint64_t> oddSeqSpins{0};
+        };
+
+        struct alignas(detail::line_align<std::atomic<std::uint64_t>>) WriterCounters {
+            std::atomic<std::uint64_t> lockSpins{0};
+            std::atomic<std::uint64_t> updates{0};
+            std::atomic<std::uint64_t> sets{0};
+            std::atomic<std::uint64_t> skipped{0};
+            std::atomic<std::uint64_t> rejected{0};
+            std::atomic<std::uint64_t> callbacks{0};
+            std::atomic<std::uint64_t> callbackNanos{0};
+        };
+
+        ReaderCounters m_reader;
+        WriterCounters m_writer;
+    };
+
+    // --- Writer lock policies ---
+    //
+    // A lock policy is default constructible and provides
+    //   std::uint64_t lock()   // returns how long it waited, in spins (0 = uncontended)
+    //   void unlock()
+    //   static constexpr bool kProcessShareable
+    // It lives inside SharedState, so it must not hold pointers.
+
+    /**
+     * @brief Default writer lock: test-and-test-and-set with exponential backoff.
+     *
+     * Waiters spin on a plain load with pause hints, doubling the pause each
+     * round, and yield the thread once the backoff is at its cap.
+     */
+    class SpinLock {
+    public:
+        static constexpr bool kProcessShareable = std::atomic<bool>::is_always_lock_free;
+        static constexpr unsigned kMaxBackoff = 64;
+
+        std::uint64_t lock() noexcept {
+            std::uint64_t spins = 0;
+            unsigned backoff = 1;
+            while (m_locked.exchange(true, std::memory_order_acquire)) {
+                // on a shared line the wait costs the holder nothing
+                do {
+                    ++spins;
+                    for (unsigned i = 0; i < backoff; ++i) {
+                        detail::cpu_relax();
+                    }
+                    if (backoff < kMaxBackoff) {
+                        backoff <<= 1;
+                    } else {
+                        detail::yield_thread();
+                    }
+                } while (m_locked.load(std::memory_order_relaxed));
             }
+            return spins;
         }
-    }
 
-    // --- Double-Buffering Members (now w/ seq) ---
-    alignas(64) Buffer m_buffers[2];
-    alignas(64) std::atomic<int> m_activeIndex;
-    std::atomic_flag m_writeLock = ATOMIC_FLAG_INIT;
+        void unlock() noexcept {
+            m_locked.store(false, std::memory_order_release);
+        }
 
-    // --- Other Members ---
-    T m_defaultConfig;
+    private:
+        std::atomic<bool> m_locked{false};
+    };
 
-    struct CallbackSlot {
-        size_t memberOffset = 0;
-        size_t memberSize = 0;
-        void (*thunk)(const void*, void*) = nullptr;
-        void* originalCallback = nullptr;
-        void* userData = nullptr;
+    /**
+     * @brief No lock at all, for designs where a single task owns every write.
+     *        Concurrent writers are undefined behaviour with this policy.
+     */
+    struct NoLock {
+        static constexpr bool kProcessShareable = true;
+
+        std::uint64_t lock() noexcept { return 0; }
+        void unlock() noexcept {}
     };
-    
-    std::array<CallbackSlot, MaxCallbacks> m_callbacks;
-    size_t m_callbackCount;
-    
-    template<typename MemberType>
-    static void callbackThunk(const void* newValue, void* slotPtr) {
-        CallbackSlot* currentSlot = static_cast<CallbackSlot*>(slotPtr);
-        const MemberType& typedValue = *static_cast<const MemberType*>(newValue);
-        auto original_fn = reinterpret_cast<void (*)(const MemberType&, void*)>(
-            currentSlot->originalCallback);
-        original_fn(typedValue, currentSlot->userData);
-    }
 
-    bool (*m_saveFunction)(const T&) = nullptr;
-    bool (*m_loadUserConfig)(T&) = nullptr;
-};
+#if defined(CONFIGLY_HAS_PTHREAD)
+    /**
+     * @brief pthread mutex with priority inheritance, so a preempted low-priority
+     *        writer is boosted instead of being spun against. Process-shared, so
+     *        it works inside a SharedState placed in shared memory.
+     */
+    class PiMutexLock {
+    public:
+        static constexpr bool kProcessShareable = true;
+
+        PiMutexLock() noexcept {
+            pthread_mutexattr_t attr;
+            pthread_mutexattr_init(&attr);
+            pthread_mutexattr_setprotocol(&attr, PTHREAD_PRIO_INHERIT);
+            pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+            const int rc = pthread_mutex_init(&m_mutex, &attr);
+            assert(rc == 0 && "pthread_mutex_init failed");
+            (void)rc;
+            pthread_mutexattr_destroy(&attr);
+        }
+
+        ~PiMutexLock() { pthread_mutex_destroy(&m_mutex); }
+
+        PiMutexLock(const PiMutexLock&) = delete;
+        PiMutexLock& operator=(const PiMutexLock&) = delete;
+
+        std::uint64_t lock() noexcept {
+            if (pthread_mutex_trylock(&m_mutex) == 0) {
+                return 0;
+            }
+            pthread_mutex_lock(&m_mutex);
+            return 1;
+        }
+
+        void unlock() noexcept { pthread_mutex_unlock(&m_mutex); }
+
+    private:
+        pthread_mutex_t m_mutex;
+    };
+#endif
+}
+
+namespace configly {
+    /**
+     * @brief Everything readers and writers share: the buffer ring, the active
+     *        index, the version counter, the writer lock and the defaults.
+     *
+     * Standard-layout and free of pointers, so it can be placed in a POSIX shm /
+     * mmap'ed segment: one process creates it (placement new + setDefault()),
+     * every other process attaches a Configly to it and reads lock-free.
+     * Callbacks, hooks and stats stay in the (process-local) Configly object.
+     */
+    template<typename T, std::size_t Buffers = 2, typename Lock = SpinLock>
+    struct SharedState {
+        // each buffer starts on its own line and is padded to whole lines, so
+        // writing one never invalidates a line a reader of another one needs
+        struct alignas(detail::line_align<std::atomic<std::uint64_t>, T>) Buffer {
+            std::atomic<std::uint64_t> seq{0};
+            std::atomic<std::uint64_t> version{0};   ///< version() it was published as, 0 = none
+            T data;
+        };
+
+        /// true iff every atomic is address-free, i.e. usable across processes
+        static constexpr bool kProcessShareable =
+            std::atomic<std::uint64_t>::is_always_lock_free && std::atomic<int>::is_always_lock_free &&
+            Lock::kProcessShareable;
+
+        /// default-initialized; setDefault() fills it in at runtime
+        SharedState() = default;
+
+        /**
+         * @brief Constant initialization: every buffer, the defaults and version 1
+         *        come straight from @p defaults, as setDefault() would leave them.
+         *
+         * In a constant-initialized static (see configly::Static) the whole state is
+         * emitted as initialized data, with no copy at startup.
+         */
+        constexpr explicit SharedState(const T& defaults)
+            : SharedState(defaults, std::make_index_sequence<Buffers>{}) {}
+
+        // --- Buffer Ring Members (w/ seq) ---
+        Buffer buffers[Buffers];
+
+        // read-mostly: written once per publish, read by every reader
+        alignas(detail::line_align<std::atomic<int>>) std::atomic<int> activeIndex{0};
+        std::atomic<std::uint64_t> version{0};
+        /// threads (of any process) sleeping in waitForChange(); writers skip the wake while 0
+        std::atomic<std::uint32_t> versionSleepers{0};
+
+        // own line: waiting writers must not slow down readers of activeIndex
+        alignas(detail::line_align<Lock>) Lock writeLock;
+
+        alignas(detail::line_align<T>) T defaults;
+
+    private:
+        template<std::size_t... Is>
+        constexpr SharedState(const T& d, std::index_sequence<Is...>)
+            : buffers{Buffer{{0}, {Is == 0 ? 1u : 0u}, d}...}, version{1}, defaults(d) {}
+    };
+
+    template<typename Cfg>
+    class Owned;
+
+    template<typename Cfg, const typename Cfg::Value& Defaults>
+    class Static;
+}
+
+namespace configly {
+    /**
+     * @brief Validation rules of T; specialized by CONFIGLY_SCHEMA.
+     */
+    template<typename T>
+    struct schema {
+        static constexpr bool kDefined = false;
+    };
+
+    // --- Schema rules ---
+    //
+    // A rule names the member it constrains as a template argument, so which
+    // rules apply to a set<&T::field>() is resolved at compile time. accepts()
+    // combines its comparisons with & instead of && and compiles to straight
+    // line code.
+
+    /**
+     * @brief Accepts min <= v <= max.
+     */
+    template<auto Member, typename V>
+    struct range_rule {
+        static constexpr auto member = Member;
+        V min;
+        V max;
+
+        constexpr bool accepts(const V& v) const noexcept { return (min <= v) & (v <= max); }
+    };
+
+    /**
+     * @brief Accepts one of N listed values.
+     */
+    template<auto Member, typename V, std::size_t N>
+    struct one_of_rule {
+        static constexpr auto member = Member;
+        V values[N];
+
+        constexpr bool accepts(const V& v) const noexcept {
+            bool hit = false;
+            for (const V& allowed : values) {
+                hit |= v == allowed;
+            }
+            return hit;
+        }
+    };
+
+    /**
+     * @brief Accepts min <= v <= max where v - min is a multiple of step; a
+     *        step <= 0 has no grid and accepts any value in range.
+     */
+    template<auto Member, typename V>
+    struct step_rule {
+        static constexpr auto member = Member;
+        V min;
+        V max;
+        V step;
+
+        constexpr bool accepts(const V& v) const noexcept {
+            // unsigned, so v < min cannot overflow; that case is already rejected
+            using U = std::make_unsigned_t<V>;
+            const U offset = static_cast<U>(static_cast<U>(v) - static_cast<U>(min));
+            const U grid = step > V{0} ? static_cast<U>(step) : U{1};
+            return (min <= v) & (v <= max) & (offset % grid == 0);
+        }
+    };
+}
+
+namespace detail {
+    template<typename MemberPtr>
+    struct member_class;
+
+    template<typename C, typename M>
+    struct member_class<M C::*> {
+        using type = C;
+    };
+
+    template<auto Member>
+    using rule_value_t = member_type_t<typename member_class<decltype(Member)>::type, decltype(Member)>;
+
+    template<auto A, auto B>
+    constexpr bool same_member() {
+        if constexpr (std::is_same_v<decltype(A), decltype(B)>) {
+            return A == B;
+        } else {
+            return false;
+        }
+    }
+
+    template<typename T>
+    constexpr std::size_t rule_count() {
+        if constexpr (configly::schema<T>::kDefined) {
+            return std::tuple_size_v<std::remove_const_t<decltype(configly::schema<T>::rules)>>;
+        } else {
+            return 0;
+        }
+    }
+
+    // rules of a member are found at compile time: a member without any folds to `true`
+    template<typename T, auto Member, std::size_t... Is>
+    constexpr bool member_accepts(const rule_value_t<Member>& value, std::index_sequence<Is...>) {
+        if constexpr (sizeof...(Is) == 0) {
+            return true;
+        } else {
+            using Rules = std::remove_const_t<decltype(configly::schema<T>::rules)>;
+            return (true & ... & [&value]() {
+                using Rule = std::tuple_element_t<Is, Rules>;
+                if constexpr (same_member<Member, Rule::member>()) {
+                    return std::get<Is>(configly::schema<T>::rules).accepts(value);
+                } else {
+                    return true;
+                }
+            }());
+        }
+    }
+
+    // runtime member pointer: every rule on a member of the same type is a candidate
+    template<typename T, typename MemberPtr, std::size_t... Is>
+    constexpr bool member_ptr_accepts(MemberPtr member, const member_type_t<T, MemberPtr>& value,
+                                      std::index_sequence<Is...>) {
+        if constexpr (sizeof...(Is) == 0) {
+            return true;
+        } else {
+            using Rules = std::remove_const_t<decltype(configly::schema<T>::rules)>;
+            return (true & ... & [member, &value]() {
+                using Rule = std::tuple_element_t<Is, Rules>;
+                if constexpr (std::is_same_v<std::remove_const_t<decltype(Rule::member)>, MemberPtr>) {
+                    return (member != Rule::member) | std::get<Is>(configly::schema<T>::rules).accepts(value);
+                } else {
+                    return true;
+                }
+            }());
+        }
+    }
+
+    template<typename T, std::size_t... Is>
+    constexpr bool config_accepts(const T& config, std::index_sequence<Is...>) {
+        if constexpr (sizeof...(Is) == 0) {
+            return true;
+        } else {
+            constexpr auto& rules = configly::schema<T>::rules;
+            return (true & ... & std::get<Is>(rules).accepts(config.*(std::get<Is>(rules).member)));
+        }
+    }
+}
+
+namespace detail {
+    // not constexpr: reaching it while the schema is built is a compile error
+    inline void step_must_be_positive() noexcept {}
+}
+
+namespace configly {
+    /**
+     * @brief Rejects values outside [min, max], e.g. `range<&AppConfig::baud>(1200, 921600)`.
+     */
+    template<auto Member>
+    constexpr auto range(detail::rule_value_t<Member> min, detail::rule_value_t<Member> max) {
+        return range_rule<Member, detail::rule_value_t<Member>>{min, max};
+    }
+
+    /**
+     * @brief Rejects values not listed, e.g. `one_of<&AppConfig::parity>(0, 1, 2)`.
+     */
+    template<auto Member, typename... Values>
+    constexpr auto one_of(Values... values) {
+        static_assert(sizeof...(Values) > 0, "one_of needs at least one value");
+        using V = detail::rule_value_t<Member>;
+        return one_of_rule<Member, V, sizeof...(Values)>{{static_cast<V>(values)...}};
+    }
+
+    /**
+     * @brief Rejects values outside [min, max] or off the grid min + k * step.
+     *        A @p step <= 0 fails to compile inside CONFIGLY_SCHEMA.
+     */
+    template<auto Member>
+    constexpr auto step(detail::rule_value_t<Member> min, detail::rule_value_t<Member> max,
+                        detail::rule_value_t<Member> step) {
+        static_assert(std::is_integral_v<detail::rule_value_t<Member>>, "step needs an integral member");
+        if (step <= detail::rule_value_t<Member>{0}) {
+            detail::step_must_be_positive();
+        }
+        return step_rule<Member, detail::rule_value_t<Member>>{min, max, step};
+    }
+
+    /**
+     * @brief true if @p value passes every rule the schema of T declares for Member.
+     */
+    template<typename T, auto Member>
+    constexpr bool accepts(const detail::rule_value_t<Member>& value) {
+        return detail::member_accepts<T, Member>(value, std::make_index_sequence<detail::rule_count<T>()>{});
+    }
+
+    /**
+     * @brief true if every member of @p config passes the schema of T.
+     */
+    template<typename T>
+    constexpr bool accepts(const T& config) {
+        return detail::config_accepts(config, std::make_index_sequence<detail::rule_count<T>()>{});
+    }
+}
+
+/**
+ * @brief Declares the schema of an aggregate. Use at global scope, next to T:
+ *        CONFIGLY_SCHEMA(AppConfig, configly::range<&AppConfig::baud>(1200, 921600),
+ *                                   configly::one_of<&AppConfig::parity>(0, 1, 2))
+ */
+#define CONFIGLY_SCHEMA(Type, ...)                                         \
+    template<>                                                             \
+    struct configly::schema<Type> {                                        \
+        static constexpr bool kDefined = true;                             \
+        static constexpr auto rules = std::make_tuple(__VA_ARGS__);        \
+    }
+
+/**
+ * @tparam T            trivially copyable config struct
+ * @tparam MaxCallbacks number of subscriber slots, shared by onChange() and
+ *                      onAnyChange() registrations
+ * @tparam Buffers      size of the snapshot ring; writers rotate through it, so a
+ *                      reader is only invalidated after Buffers - 1 publishes
+ *                      happened during its copy. The ring doubles as history:
+ *                      the last Buffers - 1 versions stay available to
+ *                      diffSince() and rollback()
+ * @tparam Stats        instrumentation policy: configly::NoStats (zero cost) or
+ *                      configly::AtomicStats
+ * @tparam Lock         writer lock policy: configly::SpinLock (default),
+ *                      configly::PiMutexLock (POSIX) or configly::NoLock
+ */
+template<typename T,
+         size_t MaxCallbacks = detail::default_max_callbacks<T>(),
+         size_t Buffers = 2,
+         typename Stats = configly::NoStats,
+         typename Lock = configly::SpinLock>
+class Configly
+{
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Config struct T must be trivially copyable.");
+    static_assert(MaxCallbacks > 0 && MaxCallbacks <= 64,
+                  "MaxCallbacks must be between 1 and 64");
+    static_assert(Buffers >= 2 && Buffers <= 64,
+                  "Buffers must be between 2 and 64");
+
+public:
+    using Value = T;
+    using State = configly::SharedState<T, Buffers, Lock>;
+
+private:
+    using Buffer = typename State::Buffer;
+
+public:
+    /**
+     * @brief Borrowed, optimistic view straight into the active buffer.
+     *
+     * Nothing is copied: the guard remembers the buffer and its seq, and valid()
+     * tells afterwards whether a writer touched the buffer in the meantime.
+     * Values read through the guard may only be trusted once valid() returned
+     * true; never follow pointers or index arrays with them before that.
+     *
+     * @code
+     * for (auto view = cfg.view();; view.retry()) {
+     *     sum = view->a + view->b;
+     *     if (view.valid()) break;
+     * }
+     * @endcode
+     */
+    class ReadGuard {
+    public:
+        [[nodiscard]] const T* get() const { return &m_buffer->data; }
+        const T& operator*() const { return m_buffer->data; }
+        const T* operator->() const { return &m_buffer->data; }
+
+        /**
+         * @brief True iff no writer reused the buffer since the guard was taken.
+         */
+        [[nodiscard]] bool valid() const {
+            // make sure we see any writes to data before re-reading seq
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return m_buffer->seq.load(std::memory_order_acquire) == m_seq;
+        }
+
+        /**
+         * @brief version() the viewed buffer was published as, 0 while that
+         *        publish is still finishing; like the data, only trust it once
+         *        valid() returned true.
+         */
+        [[nodiscard]] std::uint64_t version() const {
+            return m_buffer->version.load(std::memory_order_acquire);
+        }
+
+        /**
+         * @brief Re-targets the guard at the currently active buffer.
+         */
+        void retry() {
+            m_owner->m_stats.onReadRetry();
+            *this = m_owner->view();
+        }
+
+    private:
+        friend class Configly;
+
+        ReadGuard(const Configly& owner, const Buffer& buffer, std::uint64_t seq)
+            : m_owner(&owner), m_buffer(&buffer), m_seq(seq) {}
+
+        const Configly* m_owner;
+        const Buffer* m_buffer;
+        std::uint64_t m_seq;
+    };
+
+    /**
+     * @brief Reader-private copy of the config, refreshed only when version() moves.
+     *
+     * A repeat read costs one acquire load of the version counter and a compare;
+     * the full copy happens once per publish. Keep one per reader thread, e.g.
+     *
+     * @code
+     * thread_local Configly<AppConfig>::LocalCache cache(Configly<AppConfig>::instance());
+     * const int baud = cache.get(&AppConfig::baud);
+     * @endcode
+     */
+    class LocalCache {
+    public:
+        explicit LocalCache(const Configly& owner) : m_owner(&owner) {
+            refresh();
+        }
+
+        /**
+         * @brief Current config; recopied first if a publish happened since the last copy.
+         */
+        const T& get() {
+            if (stale()) {
+                refresh();
+            }
+            return m_data;
+        }
+
+        template<typename MemberPtr>
+        const detail::member_type_t<T, MemberPtr>& get(MemberPtr member) {
+            static_assert(std::is_member_object_pointer<MemberPtr>::value,
+                          "Member pointer required");
+            return get().*member;
+        }
+
+        const T& operator*() { return get(); }
+        const T* operator->() { return &get(); }
+
+        [[nodiscard]] bool stale() const {
+            return m_owner->version() != m_version;
+        }
+
+        /**
+         * @brief Version the copy was taken at (the copy may be slightly newer).
+         */
+        [[nodiscard]] std::uint64_t version() const { return m_version; }
+
+        void refresh() {
+            // version first: the copy that follows is at least that new
+            m_version = m_owner->version();
+            m_owner->getAll(m_data);
+        }
+
+    private:
+        const Configly* m_owner;
+        std::uint64_t m_version = 0;
+        T m_data;
+    };
+
+    /**
+     * @brief Process-wide instance for T (owns its state).
+     *
+     * For several independent instances use configly::Owned<Configly<...>>,
+     * to share one state between processes construct a Configly on a State.
+     */
+    static Configly& instance() {
+        static configly::Owned<Configly> i;
+        return i;
+    }
+
+    /**
+     * @brief Attaches to an existing state, e.g. one placed in shared memory.
+     *
+     * The state is not modified; whoever created it calls setDefault() once.
+     */
+    constexpr explicit Configly(State& state)
+        : m_state(state)
+    {}
+
+    ~Configly() = default;
+
+    Configly(const Configly&) = delete;
+    Configly& operator=(const Configly&) = delete;
+    Configly(Configly&&) = delete;
+    Configly& operator=(Configly&&) = delete;
+
+    void setDefault(const T& defaultConfig) {
+        assert(configly::accepts(defaultConfig) && "defaults violate configly::schema<T>");
+        m_state.defaults = defaultConfig;
+
+        // init all buffers with seq = 0 (even → stable) and same data, no history
+        for (Buffer& buf : m_state.buffers) {
+            buf.seq.store(0, std::memory_order_relaxed);
+            buf.version.store(0, std::memory_order_relaxed);
+            buf.data = defaultConfig;
+        }
+
+        m_state.buffers[0].version.store(m_state.version.load(std::memory_order_relaxed) + 1,
+                                         std::memory_order_relaxed);
+        m_state.activeIndex.store(0, std::memory_order_release);
+        bumpVersion();
+    }
+
+    [[nodiscard]] const T& getDefault() const {
+        return m_state.defaults;
+    }
+
+    /**
+     * @brief Number of times a reader had to restart because its buffer was
+     *        being written. Useful to tune the Buffers parameter.
+     *
+     * Counted by the Stats policy; always 0 with configly::NoStats.
+     */
+    [[nodiscard]] std::uint64_t readRetries() const {
+        const configly::StatsSnapshot s = m_stats.snapshot();
+        return s.readRetries + s.oddSeqSpins;
+    }
+
+    /**
+     * @brief Current values of the hot-path counters (all 0 with configly::NoStats).
+     */
+    [[nodiscard]] configly::StatsSnapshot stats() const {
+        return m_stats.snapshot();
+    }
+
+    /**
+     * @brief Global version counter; incremented once per publish.
+     */
+    [[nodiscard]] std::uint64_t version() const {
+        return m_state.version.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Blocks until version() differs from @p lastVersion.
+     *
+     * Sleeps in the WaitHooks if set, else on a futex (Linux) or in C++20
+     * std::atomic::wait. Elsewhere it is a yielding poll that keeps the core busy.
+     * @return the new version
+     */
+    std::uint64_t waitForChange(std::uint64_t lastVersion) const {
+        for (;;) {
+            const std::uint64_t current = version();
+            if (current != lastVersion) {
+                return current;
+            }
+            if (m_waitHooks.wait) {
+                m_waitHooks.wait(m_waitHooks.context, configly::WaitHooks::kWaitForever);
+            } else {
+#if defined(CONFIGLY_HAS_FUTEX)
+                detail::futex_wait(m_state.version, m_state.versionSleepers, lastVersion, -1,
+                                   State::kProcessShareable);
+#elif defined(__cpp_lib_atomic_wait)
+                m_state.version.wait(lastVersion, std::memory_order_acquire);
+#else
+                detail::yield_thread();
+#endif
+            }
+        }
+    }
+
+    /**
+     * @brief Like waitForChange(lastVersion), but gives up after @p timeout.
+     *
+     * Sleeps with a deadline in the WaitHooks or on a futex; std::atomic::wait
+     * has no timeout, so without either this is a yielding poll.
+     * @return the new version, or @p lastVersion on timeout
+     */
+    template<typename Rep, typename Period>
+    std::uint64_t waitForChange(std::uint64_t lastVersion,
+                                const std::chrono::duration<Rep, Period>& timeout) const {
+        using Clock = std::chrono::steady_clock;
+        const Clock::time_point deadline =
+            Clock::now() + std::chrono::duration_cast<Clock::duration>(timeout);
+
+        for (;;) {
+            const std::uint64_t current = version();
+            if (current != lastVersion) {
+                return current;
+            }
+            const Clock::time_point now = Clock::now();
+            if (now >= deadline) {
+                return lastVersion;
+            }
+            if (m_waitHooks.wait) {
+                const auto remaining = std::chrono::duration_cast<std::chrono::microseconds>(deadline - now);
+                m_waitHooks.wait(m_waitHooks.context, static_cast<std::uint64_t>(remaining.count()) + 1);
+            } else {
+#if defined(CONFIGLY_HAS_FUTEX)
+                const auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - now);
+                detail::futex_wait(m_state.version, m_state.versionSleepers, lastVersion,
+                                   static_cast<std::int64_t>(remaining.count()), State::kProcessShareable);
+#else
+                detail::yield_thread();
+#endif
+            }
+        }
+    }
+
+    /**
+     * @brief Installs OS wait/notify hooks for waitForChange(). Set during setup.
+     */
+    void setWaitHooks(const configly::WaitHooks& hooks) {
+        m_waitHooks = hooks;
+    }
+
+    /**
+     * @brief Takes a zero-copy ReadGuard on the active buffer.
+     */
+    [[nodiscard]] ReadGuard view() const {
+        for (;;) {
+            int idx = m_state.activeIndex.load(std::memory_order_acquire);
+            const Buffer& buf = m_state.buffers[idx];
+
+            // read start sequence
+            std::uint64_t seq = buf.seq.load(std::memory_order_acquire);
+
+            // an even seq alone is not enough: with a stale index the buffer may
+            // already be rewritten but not yet (or never) published. Its version
+            // stays 0 until activate() has made it the active one; version 0 on
+            // the active buffer itself only happens before the first setDefault()
+            if (!(seq & 1u) && (buf.version.load(std::memory_order_acquire) != 0 ||
+                                m_state.activeIndex.load(std::memory_order_acquire) == idx)) {
+                return ReadGuard(*this, buf, seq);
+            }
+            // writer in progress on this buffer, or it is not published yet
+            m_stats.onOddSeq();
+        }
+    }
+
+    /**
+     * @brief Atomically retrieves a consistent snapshot of the entire current configuration.
+     */
+    void getAll(T& outConfig) const {
+        readStable([&outConfig](const T& data) { detail::copy_config(outConfig, data); });
+    }
+
+    /**
+     * @brief Reads a single member without copying the rest of the struct.
+     *
+     * Runs the same seq start/end check as getAll(), but only sizeof(member)
+     * bytes are copied out of the active buffer.
+     */
+    template<typename MemberPtr>
+    [[nodiscard]] auto get(MemberPtr member) const {
+        static_assert(std::is_member_object_pointer<MemberPtr>::value,
+                      "Member pointer required");
+
+        detail::member_type_t<T, MemberPtr> value;
+        readStable([&value, member](const T& data) { value = data.*member; });
+        return value;
+    }
+
+    /**
+     * @brief Reads several members from one consistent snapshot.
+     * @return std::tuple with the values, in the order the members were given.
+     */
+    template<typename MemberPtr0, typename MemberPtr1, typename... MemberPtrs>
+    [[nodiscard]] auto get(MemberPtr0 member0, MemberPtr1 member1, MemberPtrs... members) const {
+        static_assert(std::is_member_object_pointer<MemberPtr0>::value &&
+                      std::is_member_object_pointer<MemberPtr1>::value &&
+                      (std::is_member_object_pointer<MemberPtrs>::value && ...),
+                      "Member pointer required");
+
+        std::tuple<detail::member_type_t<T, MemberPtr0>,
+                   detail::member_type_t<T, MemberPtr1>,
+                   detail::member_type_t<T, MemberPtrs>...> values;
+        readStable([&values, member0, member1, members...](const T& data) {
+            values = std::tie(data.*member0, data.*member1, data.*members...);
+        });
+        return values;
+    }
+    
+    /**
+     * @brief Atomically updates the entire configuration from an in-memory struct.
+     *
+     * If @p new_config is byte-identical to the active config nothing is
+     * published: no buffer is written, version() stays and no reader retries.
+     * The same holds for set(), modify() and flushes whose result is unchanged.
+     *
+     * @return false if @p new_config fails configly::schema<T>; nothing is
+     *         written then, not even the inactive buffer
+     */
+    bool update(const T& new_config) {
+        return writeConfig(new_config, nullptr);
+    }
+
+    /**
+     * @brief update() that only goes ahead if version() still is
+     *        @p expectedVersion, e.g. because @p new_config was derived from
+     *        the config published as that version.
+     * @return false if a write came first (version() moved on), or if
+     *         @p new_config fails configly::schema<T>
+     */
+    bool compareAndUpdate(std::uint64_t expectedVersion, const T& new_config) {
+        return writeConfig(new_config, &expectedVersion);
+    }
+
+    /**
+     * @brief Applies several edits as one write: the active buffer is copied once,
+     *        @p edit runs on the copy, and the result is published once.
+     *
+     * Readers never observe intermediate states, and callbacks fire only for the
+     * fields whose bytes changed. @p edit runs under the writer lock, so it must
+     * be short and must not call back into this Configly's writers.
+     *
+     * @code
+     * cfg.modify([](AppConfig& c) { c.baud = 115200; c.parity = 0; });
+     * @endcode
+     */
+    template<typename Edit>
+    void modify(Edit&& edit) {
+        tryModify([&edit](T& config) {
+            edit(config);
+            return true;
+        });
+    }
+
+    /**
+     * @brief modify() whose @p edit may refuse: if it returns false, the edited
+     *        copy is dropped, nothing is published and no callback fires.
+     *
+     * An edited copy that fails configly::schema<T> is dropped the same way.
+     * A T of up to CONFIGLY_STACK_EDIT_MAX bytes is edited in a stack copy, so
+     * a refused or no-op edit opens no buffer and the history stays intact.
+     * A bigger T is edited in the opened buffer, copying the active one only
+     * once; a refused or no-op edit then costs the oldest history snapshot.
+     * @return what @p edit returned, false if the schema rejected the result
+     */
+    template<typename Edit>
+    bool tryModify(Edit&& edit) {
+        m_stats.onUpdate();
+        if (isCoalescing()) {
+            bool accepted = false;
+            bool rejected = false;
+            stage([&edit, &accepted, &rejected](T& staged) {
+                const T before = staged;
+                accepted = edit(staged);
+                rejected = accepted && !configly::accepts(staged);
+                if (!accepted || rejected) {
+                    staged = before;
+                    accepted = false;
+                    return std::uint64_t{0};
+                }
+                return changedFields(before, staged);
+            });
+            if (rejected) {
+                m_stats.onRejectedWrite();
+            }
+            return accepted;
+        }
+
+        lockWriter();
+        const T& current = m_state.buffers[m_state.activeIndex.load(std::memory_order_relaxed)].data;
+
+        if constexpr (sizeof(T) <= CONFIGLY_STACK_EDIT_MAX) {
+            // the edit runs on a copy: opening the next buffer would evict the
+            // snapshot it holds, so a refused, rejected or no-op edit opens none
+            T edited = current;
+            if (!edit(edited)) {
+                unlockWriter();
+                return false;
+            }
+            if (!configly::accepts(edited)) {
+                unlockWriter();
+                m_stats.onRejectedWrite();
+                return false;
+            }
+            if (detail::first_difference(&current, &edited, 0, sizeof(T)) == sizeof(T)) {
+                unlockWriter();
+                m_stats.onSkippedPublish();
+                return true;
+            }
+
+            const int inactive_idx = openNextBuffer();
+            detail::copy_config(m_state.buffers[inactive_idx].data, edited);
+            commitWrite(inactive_idx, current);
+        } else {
+            // too big for the writer's stack: copy current config once into the
+            // opened buffer and apply every edit there
+            const int inactive_idx = openNextBuffer();
+            T& target = m_state.buffers[inactive_idx].data;
+            detail::copy_config(target, current);
+            if (!edit(target)) {
+                abandon(inactive_idx);
+                return false;
+            }
+            // the seq is still odd, and abandon() leaves the buffer unpublished
+            if (!configly::accepts(target)) {
+                abandon(inactive_idx);
+                m_stats.onRejectedWrite();
+                return false;
+            }
+            if (detail::first_difference(&current, &target, 0, sizeof(T)) == sizeof(T)) {
+                abandon(inactive_idx);
+                m_stats.onSkippedPublish();
+                return true;
+            }
+            commitWrite(inactive_idx, current);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Set a specific member value and trigger its callback if registered.
+     *
+     * The member is only known at run time here, so every schema rule on a
+     * member of the same type is evaluated (and masked out unless it matches).
+     * @return false if configly::schema<T> rejects @p value; nothing is written
+     */
+    template<typename MemberPtr, typename ValueType>
+    bool set(MemberPtr member, ValueType&& value) {
+        static_assert(std::is_member_object_pointer<MemberPtr>::value,
+                      "Member pointer required");
+
+        return writeMember(
+            member, std::forward<ValueType>(value),
+            [this, member]() { return findWatch(calculateOffset(member)); },
+            [this, member]() { return std::uint64_t{1} << fieldAt(calculateOffset(member)); },
+            [member](const auto& v) {
+                return detail::member_ptr_accepts<T>(member, v, std::make_index_sequence<detail::rule_count<T>()>{});
+            });
+    }
+
+    /**
+     * @brief Compile-time bound variant of set(), e.g. `set<&AppConfig::baud>(v)`.
+     *
+     * The member's position in T is resolved at compile time, so after the first
+     * call its watch entry is a single table lookup instead of a scan. So are its
+     * schema rules: only those of Member are inlined, none for a free member.
+     * @return false if configly::schema<T> rejects @p value; nothing is written
+     */
+    template<auto Member, typename ValueType>
+    bool set(ValueType&& value) {
+        static_assert(std::is_member_object_pointer<decltype(Member)>::value,
+                      "Member pointer required");
+
+        return writeMember(
+            Member, std::forward<ValueType>(value),
+            [this]() { return fieldWatch<Member>(); },
+            []() { return memberFieldBit<Member>(); },
+            [](const auto& v) { return configly::accepts<T, Member>(v); });
+    }
+
+    /**
+     * @brief Compile-time bound variant of get(), e.g. `get<&AppConfig::baud>()`.
+     */
+    template<auto Member>
+    [[nodiscard]] auto get() const {
+        return get(Member);
+    }
+
+    /**
+     * @brief Subscribes @p user_callback to changes of @p member.
+     *
+     * A member may have several subscribers; each registration takes one of the
+     * MaxCallbacks slots, and they run in registration-slot order.
+     */
+    template<typename MemberPtr>
+    Configly& onChange(
+        MemberPtr member,
+        void (*user_callback)(const detail::member_type_t<T, MemberPtr>&, void*),
+        void* user_context = nullptr) {
+        
+        static_assert(std::is_member_object_pointer<MemberPtr>::value,
+                      "Member pointer required");
+
+        return subscribe(calculateOffset(member), user_callback, user_context);
+    }
+
+    template<auto Member>
+    Configly& onChange(
+        void (*user_callback)(const detail::member_type_t<T, decltype(Member)>&, void*),
+        void* user_context = nullptr) {
+        static_assert(std::is_member_object_pointer<decltype(Member)>::value,
+                      "Member pointer required");
+        return subscribe(memberOffset<Member>(), user_callback, user_context);
+    }
+
+    /**
+     * @brief Group subscription: @p user_callback runs once per publish that
+     *        changed any of @p members, with the whole new config.
+     *
+     * @code
+     * cfg.onAnyChange(&onLinkChange, nullptr, &AppConfig::baud, &AppConfig::parity);
+     * @endcode
+     */
+    template<typename... MemberPtrs>
+    Configly& onAnyChange(void (*user_callback)(const T&, void*), void* user_context,
+                          MemberPtrs... members) {
+        static_assert(sizeof...(MemberPtrs) > 0, "At least one member required");
+        static_assert((std::is_member_object_pointer<MemberPtrs>::value && ...),
+                      "Member pointer required");
+
+        const detail::field_span spans[] = {{calculateOffset(members), sizeof(detail::member_type_t<T, MemberPtrs>)}...};
+        return subscribeGroup(user_callback, user_context, spans, sizeof...(MemberPtrs));
+    }
+
+    template<auto... Members>
+    Configly& onAnyChange(void (*user_callback)(const T&, void*), void* user_context = nullptr) {
+        static_assert(sizeof...(Members) > 0, "At least one member required");
+        static_assert((std::is_member_object_pointer<decltype(Members)>::value && ...),
+                      "Member pointer required");
+
+        const detail::field_span spans[] = {
+            {memberOffset<Members>(), sizeof(detail::member_type_t<T, decltype(Members)>)}...};
+        return subscribeGroup(user_callback, user_context, spans, sizeof...(Members));
+    }
+
+    /**
+     * @brief Drops every onChange() subscriber of @p member.
+     */
+    template<typename MemberPtr>
+    void removeCallback(MemberPtr member) {
+        removeMemberCallbacks(calculateOffset(member));
+    }
+
+    /**
+     * @brief Drops the onAnyChange() subscriptions made with @p user_callback.
+     */
+    void removeAnyChange(void (*user_callback)(const T&, void*)) {
+        for (std::size_t sub = 0; sub < MaxCallbacks; ++sub) {
+            const auto& slot = m_subscribers[sub];
+            if (slot.thunk == &groupThunk && slot.callback == reinterpret_cast<void*>(user_callback)) {
+                releaseSubscriber(sub);
+            }
+        }
+    }
+
+    /**
+     * @brief Drops only the onAnyChange() subscriptions of @p user_callback
+     *        that were made with @p user_context.
+     */
+    void removeAnyChange(void (*user_callback)(const T&, void*), void* user_context) {
+        for (std::size_t sub = 0; sub < MaxCallbacks; ++sub) {
+            const auto& slot = m_subscribers[sub];
+            if (slot.thunk == &groupThunk && slot.callback == reinterpret_cast<void*>(user_callback) &&
+                slot.context == user_context) {
+                releaseSubscriber(sub);
+            }
+        }
+    }
+
+    template<auto Member>
+    void removeCallback() {
+        removeMemberCallbacks(memberOffset<Member>());
+    }
+
+    /**
+     * @brief Chooses whether callbacks run on the writer's thread or are deferred.
+     *
+     * In Deferred mode writers only mark the changed fields in a fixed-size,
+     * lock-free pending set (one bit per watched field, so repeated changes to
+     * the same field coalesce). Meant to be set once during setup.
+     */
+    void setDispatchMode(configly::DispatchMode mode) {
+        m_dispatchMode = mode;
+    }
+
+    /**
+     * @brief Coalesces bursts of writes: publishes at most once per @p interval.
+     *
+     * While enabled, update()/modify()/set() land in a process-local staging
+     * copy and only the fields they touched are merged into the next buffer
+     * when it is published. A write publishes straight away if @p interval has
+     * passed since the last publish; otherwise it waits for flush() or
+     * flushIfDue(), so call one of them periodically. Readers keep seeing the
+     * last published config meanwhile, and callbacks fire once per publish.
+     * A zero interval disables coalescing and flushes what is staged.
+     */
+    void setCoalescing(std::chrono::microseconds interval) {
+        if (interval.count() == 0) {
+            m_coalesceInterval = interval;
+            flush();
+            return;
+        }
+        lockWriter();
+        m_coalesceInterval = interval;
+        // the first write of a burst goes out immediately
+        m_lastFlush = std::chrono::steady_clock::now() - interval;
+        unlockWriter();
+    }
+
+    /**
+     * @brief Publishes the staged writes now.
+     * @return true if anything was staged
+     */
+    bool flush() {
+        return flushStaged(false);
+    }
+
+    /**
+     * @brief flush(), but only once the coalescing interval has elapsed.
+     */
+    bool flushIfDue() {
+        return flushStaged(true);
+    }
+
+    /**
+     * @brief Runs the callbacks queued in Deferred mode, once per subscriber of
+     *        a changed field, with the latest value of that field.
+     *
+     * Intended to be called from a single task of your choosing; all callbacks
+     * of one call see the same consistent snapshot.
+     * @return number of callbacks that were run
+     */
+    size_t dispatchPending() {
+        std::uint64_t mask = m_pendingWatches.exchange(0, std::memory_order_acquire);
+        if (mask == 0) {
+            return 0;
+        }
+
+        T snapshot;
+        getAll(snapshot);
+
+        return dispatchWatches(mask, snapshot);
+    }
+
+    void setSaveFunction(bool (*fn)(const T&)) { 
+        m_saveHook = {fn ? &plainSaveThunk : nullptr, reinterpret_cast<void*>(fn), nullptr};
+    }
+    
+    void setLoadFunction(bool (*fn)(T&)) { 
+        m_loadUserConfig = fn ? &plainLoadThunk : nullptr;
+        m_loadContext = reinterpret_cast<void*>(fn);
+    }
+
+    /**
+     * @brief Context-carrying variants, for backends that are objects
+     *        (see configly/mmap_store.hpp).
+     */
+    void setSaveFunction(bool (*fn)(const T&, void*), void* context) {
+        m_saveHook = {fn ? &contextSaveThunk : nullptr, reinterpret_cast<void*>(fn), context};
+    }
+
+    void setLoadFunction(bool (*fn)(T&, void*), void* context) {
+        m_loadUserConfig = fn;
+        m_loadContext = context;
+    }
+
+    /**
+     * @brief Incremental variant: @p fn also receives the dirtyFields() mask
+     *        that this save covers (see configly/journal.hpp).
+     */
+    void setSaveFunction(bool (*fn)(const T&, std::uint64_t, void*), void* context) {
+        m_saveHook = {fn ? &incrementalSaveThunk : nullptr, reinterpret_cast<void*>(fn), context};
+    }
+
+    /**
+     * @brief Fields written since the last successful save(), bit i being the
+     *        i-th field of T in declaration order (bit 0 only, if T cannot be
+     *        reflected). Tracked only while a save function is set.
+     */
+    [[nodiscard]] std::uint64_t dirtyFields() const {
+        return m_dirtyFields.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] bool save() const {
+        if (!m_saveHook.thunk) return false;
+        // claim the mask before the snapshot, so a concurrent write stays dirty
+        const std::uint64_t dirty = m_dirtyFields.exchange(0, std::memory_order_acq_rel);
+        T tempConfig;
+        getAll(tempConfig);
+        if (m_saveHook.thunk(m_saveHook, tempConfig, dirty)) {
+            return true;
+        }
+        m_dirtyFields.fetch_or(dirty, std::memory_order_acq_rel);
+        return false;
+    }
+
+    [[nodiscard]] bool load() {
+        if (!m_loadUserConfig) return false;
+        T tempConfig;
+        if (!m_loadUserConfig(tempConfig, m_loadContext) || !update(tempConfig)) {
+            // nothing stored went live, so what was dirty stays dirty
+            return false;
+        }
+        // what is live now is what is stored
+        m_dirtyFields.store(0, std::memory_order_release);
+        return true;
+    }
+
+    void restoreDefaults() {
+        update(m_state.defaults);
+    }
+
+    /**
+     * @brief Fields that differ between version @p since and the current config.
+     *
+     * @p since is looked up in the snapshot ring, so it works for the last
+     * Buffers - 1 versions and nothing is copied. Bit i is the i-th field of T,
+     * as in dirtyFields().
+     * @return the changed-field mask, or all bits set if @p since is no longer
+     *         (or not yet) in the ring
+     */
+    [[nodiscard]] std::uint64_t diffSince(std::uint64_t since) const {
+        if (since == 0) {
+            // version 0 tags buffers being written or never published, not a snapshot
+            return ~std::uint64_t{0};
+        }
+        for (auto guard = view();; guard.retry()) {
+            const Buffer* old = nullptr;
+            std::uint64_t oldSeq = 0;
+            for (const Buffer& buf : m_state.buffers) {
+                oldSeq = buf.seq.load(std::memory_order_acquire);
+                if ((oldSeq & 1u) == 0 && buf.version.load(std::memory_order_relaxed) == since) {
+                    old = &buf;
+                    break;
+                }
+            }
+            const std::uint64_t mask = old ? changedFields(old->data, *guard) : ~std::uint64_t{0};
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            const bool oldStable = !old || old->seq.load(std::memory_order_relaxed) == oldSeq;
+            if (oldStable && guard.valid()) {
+                return mask;
+            }
+        }
+    }
+
+    /**
+     * @brief Makes version @p target the active config again, as a new version.
+     *
+     * The bytes of @p target are copied into the next buffer of the ring and
+     * published from there, like any write: the slot that held @p target keeps
+     * its place, so the ring still holds the last Buffers - 1 versions in
+     * order. Readers, waiters, dirty tracking and callbacks all see an
+     * ordinary publish. Coalesced writes that were still staged are dropped.
+     * @return false if @p target is no longer in the ring
+     */
+    bool rollback(std::uint64_t target) {
+        lockWriter();
+        m_stagedFields = 0;
+
+        const int active = m_state.activeIndex.load(std::memory_order_relaxed);
+        int found = -1;
+        for (int i = 0; i < static_cast<int>(Buffers); ++i) {
+            if (m_state.buffers[i].version.load(std::memory_order_relaxed) == target && target != 0) {
+                found = i;
+                break;
+            }
+        }
+        if (found < 0 || found == active) {
+            unlockWriter();
+            return found >= 0;
+        }
+
+        const T& current = m_state.buffers[active].data;
+        if (detail::first_difference(&current, &m_state.buffers[found].data, 0, sizeof(T)) == sizeof(T)) {
+            unlockWriter();
+            m_stats.onSkippedPublish();
+            return true;
+        }
+
+        // the oldest snapshot is overwritten, as by any write; if that is
+        // @p target itself, its bytes are already in place
+        const int inactive_idx = openNextBuffer();
+        if (inactive_idx != found) {
+            detail::copy_config(m_state.buffers[inactive_idx].data, m_state.buffers[found].data);
+        }
+        commitWrite(inactive_idx, current);
+        return true;
+    }
+
+    template<typename MemberPtr>
+    void restoreDefault(MemberPtr member) {
+        set(member, m_state.defaults.*member);
+    }
+
+    template<auto Member>
+    void restoreDefault() {
+        set<Member>(m_state.defaults.*Member);
+    }
+
+private:
+    static constexpr std::size_t kFieldCount = detail::reflected_fields<T>();
+    static constexpr std::size_t kTrackedFields = kFieldCount > 0 ? kFieldCount : 1;
+    static constexpr std::uint8_t kNoSlot = 0xFE;
+    static constexpr std::uint8_t kUnresolvedSlot = 0xFF;
+
+    /**
+     * @brief Runs @p reader against the active buffer until it observes a stable one.
+     *
+     * @p reader receives the buffer contents and must only copy out what it needs;
+     * it may run more than once if a writer reused the buffer during the copy.
+     */
+    template<typename Reader>
+    void readStable(Reader&& reader) const {
+        for (ReadGuard guard = view();; guard.retry()) {
+            // copy data
+            reader(*guard);
+
+            // success iff the buffer's seq did not move
+            if (guard.valid()) {
+                return;
+            }
+        }
+    }
+
+    [[nodiscard]] static constexpr int nextIndex(int idx) {
+        return idx + 1 == static_cast<int>(Buffers) ? 0 : idx + 1;
+    }
+
+    template<typename MemberPtr>
+    [[nodiscard]] size_t calculateOffset(MemberPtr member) const {
+        // measured on an object that already exists, so no temporary T is built
+        return reinterpret_cast<const char*>(&(m_state.defaults.*member))
+               - reinterpret_cast<const char*>(&m_state.defaults);
+    }
+
+    /**
+     * @brief Offset of a compile-time bound member; a constant when T is reflectable.
+     */
+    template<auto Member>
+    [[nodiscard]] size_t memberOffset() const {
+        if constexpr (kFieldCount > 0) {
+            constexpr std::size_t offset = detail::member_offset<T, Member>();
+            static_assert(offset < sizeof(T), "Member is not a member of T");
+            return offset;
+        } else {
+            return calculateOffset(Member);
+        }
+    }
+
+    /**
+     * @brief Bit of @p Member in the changed / dirty field masks.
+     */
+    template<auto Member>
+    [[nodiscard]] static constexpr std::uint64_t memberFieldBit() {
+        if constexpr (kFieldCount > 0) {
+            return std::uint64_t{1} << detail::field_index<T, Member>();
+        } else {
+            return 1;  // one field covering all of T
+        }
+    }
+
+    template<typename MemberType>
+    Configly& subscribe(size_t offset, void (*user_callback)(const MemberType&, void*), void* user_context) {
+        assert(offset < sizeof(T) && "Invalid member offset");
+
+        const std::size_t sub = freeSubscriber();
+        const std::size_t watch = sub != kNoSlot ? watchFor(offset, sizeof(MemberType)) : kNoSlot;
+        if (watch == kNoSlot) {
+            return *this;
+        }
+
+        auto& slot = m_subscribers[sub];
+        slot.thunk = &memberThunk<MemberType>;
+        slot.callback = reinterpret_cast<void*>(user_callback);
+        slot.context = user_context;
+        slot.memberOffset = offset;
+        m_watches[watch].subscribers |= std::uint64_t{1} << sub;
+        return *this;
+    }
+
+    Configly& subscribeGroup(void (*user_callback)(const T&, void*), void* user_context,
+                             const detail::field_span* members, std::size_t count) {
+        const std::size_t sub = freeSubscriber();
+        if (sub == kNoSlot) {
+            return *this;
+        }
+
+        const std::uint64_t bit = std::uint64_t{1} << sub;
+        for (std::size_t i = 0; i < count; ++i) {
+            const std::size_t watch = watchFor(members[i].offset, members[i].size);
+            if (watch == kNoSlot) {
+                // out of watch entries: do not leave a partial group behind
+                for (auto& w : m_watches) {
+                    w.subscribers &= ~bit;
+                }
+                return *this;
+            }
+            m_watches[watch].subscribers |= bit;
+        }
+
+        auto& slot = m_subscribers[sub];
+        slot.thunk = &groupThunk;
+        slot.callback = reinterpret_cast<void*>(user_callback);
+        slot.context = user_context;
+        slot.memberOffset = 0;
+        return *this;
+    }
+
+    void removeMemberCallbacks(size_t offset) {
+        const std::size_t watch = findWatch(offset);
+        if (watch == kNoSlot) {
+            return;
+        }
+        std::uint64_t subs = m_watches[watch].subscribers;
+        for (; subs != 0; subs &= subs - 1) {
+            const unsigned sub = detail::ctz64(subs);
+            if (m_subscribers[sub].thunk != &groupThunk) {
+                releaseSubscriber(sub);
+            }
+        }
+    }
+
+    [[nodiscard]] std::size_t findWatch(size_t offset) const {
+        for (size_t i = 0; i < m_watchCount; ++i) {
+            if (m_watches[i].memberOffset == offset) {
+                return i;
+            }
+        }
+        return kNoSlot;
+    }
+
+    /**
+     * @brief Watch entry of the member at @p offset, appended if it has none yet.
+     * @return kNoSlot if every watch entry is taken
+     */
+    std::size_t watchFor(size_t offset, size_t size) {
+        const std::size_t found = findWatch(offset);
+        if (found != kNoSlot) {
+            return found;
+        }
+
+        assert(m_watchCount < kMaxWatches && "Exceeded maximum number of watched members!");
+        if (m_watchCount >= kMaxWatches) {
+            return kNoSlot;
+        }
+
+        auto& watch = m_watches[m_watchCount];
+        watch.memberOffset = offset;
+        watch.memberSize = size;
+        watch.subscribers = 0;
+
+        // keep the offset-sorted view used by changedWatches() in order
+        size_t pos = m_watchCount;
+        for (; pos > 0 && m_watches[m_watchOrder[pos - 1]].memberOffset > offset; --pos) {
+            m_watchOrder[pos] = m_watchOrder[pos - 1];
+        }
+        m_watchOrder[pos] = static_cast<std::uint8_t>(m_watchCount);
+
+        // fields cached as "not watched" may be watched now
+        m_fieldWatches.fill(kUnresolvedSlot);
+        return m_watchCount++;
+    }
+
+    std::size_t freeSubscriber() const {
+        for (std::size_t sub = 0; sub < MaxCallbacks; ++sub) {
+            if (!m_subscribers[sub].thunk) {
+                return sub;
+            }
+        }
+        assert(false && "Exceeded maximum number of callbacks!");
+        return kNoSlot;
+    }
+
+    void releaseSubscriber(std::size_t sub) {
+        const std::uint64_t bit = std::uint64_t{1} << sub;
+        for (size_t i = 0; i < m_watchCount; ++i) {
+            m_watches[i].subscribers &= ~bit;
+        }
+        m_subscribers[sub] = Subscriber{};
+    }
+
+    /**
+     * @brief Watch entry of a compile-time bound member.
+     *
+     * Watch entries never move once assigned, so the result of the first scan is
+     * cached per field; watchFor() clears the cache when it appends an entry.
+     */
+    template<auto Member>
+    std::size_t fieldWatch() {
+        if constexpr (kFieldCount > 0) {
+            std::uint8_t& cached = m_fieldWatches[detail::field_index<T, Member>()];
+            if (cached == kUnresolvedSlot) {
+                cached = static_cast<std::uint8_t>(findWatch(memberOffset<Member>()));
+            }
+            return cached;
+        } else {
+            return findWatch(memberOffset<Member>());
+        }
+    }
+
+    /**
+     * @brief Shared body of both set() flavours.
+     *
+     * @p resolveWatch runs under the write lock and only when the value changed;
+     * @p fieldBit gives the member's bit in the field masks.
+     * @p accepts checks the converted value against the schema before any
+     * buffer is opened.
+     */
+    template<typename MemberPtr, typename ValueType, typename WatchResolver, typename FieldBit,
+             typename Validator>
+    bool writeMember(MemberPtr member, ValueType&& value, WatchResolver&& resolveWatch, FieldBit&& fieldBit,
+                     Validator&& accepts) {
+        m_stats.onSet();
+        if (isCoalescing()) {
+            bool accepted = false;
+            stage([member, &value, &fieldBit, &accepts, &accepted](T& staged) {
+                detail::member_type_t<T, MemberPtr> assigned = staged.*member;
+                assigned = std::forward<ValueType>(value);
+                accepted = accepts(assigned);
+                if (!accepted) {
+                    return std::uint64_t{0};
+                }
+                staged.*member = assigned;
+                return fieldBit();
+            });
+            if (!accepted) {
+                m_stats.onRejectedWrite();
+            }
+            return accepted;
+        }
+
+        lockWriter();
+        const T& current = m_state.buffers[m_state.activeIndex.load(std::memory_order_relaxed)].data;
+
+        detail::member_type_t<T, MemberPtr> assigned = current.*member;
+        assigned = std::forward<ValueType>(value);
+        if (!accepts(assigned)) {
+            unlockWriter();
+            m_stats.onRejectedWrite();
+            return false;
+        }
+
+        // writing the value it already has is not a publish
+        if (std::memcmp(&assigned, &(current.*member), sizeof(assigned)) == 0) {
+            unlockWriter();
+            m_stats.onSkippedPublish();
+            return true;
+        }
+
+        const int inactive_idx = openNextBuffer();
+        Buffer& target = m_state.buffers[inactive_idx];
+
+        // copy current config then modify field
+        detail::copy_config(target.data, current);
+        target.data.*member = assigned;
+
+        // trigger callbacks if actually changed
+        const bool changed = !((current.*member) == (target.data.*member));
+        const std::size_t watch = changed ? resolveWatch() : kNoSlot;
+        if (changed && m_saveHook.thunk) {
+            markDirty(fieldBit());
+        }
+
+        publish(inactive_idx);
+        notifyChanged(watch != kNoSlot ? std::uint64_t{1} << watch : 0, target.data);
+        return true;
+    }
+
+    /**
+     * @brief Body of update() and compareAndUpdate(); no @p expectedVersion
+     *        means unconditional.
+     */
+    bool writeConfig(const T& new_config, const std::uint64_t* expectedVersion) {
+        m_stats.onUpdate();
+        if (!configly::accepts(new_config)) {
+            m_stats.onRejectedWrite();
+            return false;
+        }
+        if (isCoalescing()) {
+            bool current = true;
+            stage([this, &new_config, expectedVersion, &current](T& staged) {
+                current = !expectedVersion || version() == *expectedVersion;
+                if (!current) {
+                    return std::uint64_t{0};
+                }
+                detail::copy_config(staged, new_config);
+                return ~std::uint64_t{0};
+            });
+            return current;
+        }
+
+        // serialize writers, open the next buffer
+        lockWriter();
+        if (expectedVersion && m_state.version.load(std::memory_order_relaxed) != *expectedVersion) {
+            unlockWriter();
+            return false;
+        }
+        const T& current = m_state.buffers[m_state.activeIndex.load(std::memory_order_relaxed)].data;
+
+        // a re-push of the same config touches no buffer and wakes no reader
+        if (detail::first_difference(&current, &new_config, 0, sizeof(T)) == sizeof(T)) {
+            unlockWriter();
+            m_stats.onSkippedPublish();
+            return true;
+        }
+
+        const int inactive_idx = openNextBuffer();
+        Buffer& target = m_state.buffers[inactive_idx];
+
+        // actual data write
+        detail::copy_config(target.data, new_config);
+
+        commitWrite(inactive_idx, current);
+        return true;
+    }
+
+    void lockWriter() {
+        const std::uint64_t spins = m_state.writeLock.lock();
+        if (spins != 0) {
+            m_stats.onLockSpins(spins);
+        }
+    }
+
+    void unlockWriter() {
+        m_state.writeLock.unlock();
+    }
+
+    /**
+     * @brief Opens the next buffer of the ring (seq odd); writer lock must be held.
+     * @return index of the opened buffer; hand it to publish() when done
+     */
+    int openNextBuffer() {
+        int inactive_idx = nextIndex(m_state.activeIndex.load(std::memory_order_relaxed));
+        Buffer& target = m_state.buffers[inactive_idx];
+
+        // start write: make seq odd
+        std::uint64_t seq = target.seq.load(std::memory_order_relaxed);
+        target.seq.store(seq + 1, std::memory_order_relaxed);   // odd → writer active
+        target.version.store(0, std::memory_order_relaxed);      // its old version is gone
+
+        // keep the data writes that follow from becoming visible before the odd seq
+        std::atomic_thread_fence(std::memory_order_release);
+
+        return inactive_idx;
+    }
+
+    /**
+     * @brief Closes the buffer opened by openNextBuffer(), makes it the active one
+     *        and releases the writer lock.
+     */
+    void publish(int idx) {
+        Buffer& target = m_state.buffers[idx];
+
+        // end write: make seq even
+        std::uint64_t seq = target.seq.load(std::memory_order_relaxed);
+        target.seq.store(seq + 1, std::memory_order_release);   // even → stable
+
+        activate(idx);
+    }
+
+    /**
+     * @brief Makes the stable buffer @p idx the active one as a new version and
+     *        releases the writer lock.
+     */
+    void activate(int idx) {
+        const std::uint64_t next = m_state.version.load(std::memory_order_relaxed) + 1;
+
+        // publish; the buffer's version goes last, so a reader whose view()
+        // accepted this buffer also sees it as the active one afterwards
+        m_state.activeIndex.store(idx, std::memory_order_release);
+        m_state.buffers[idx].version.store(next, std::memory_order_release);
+        m_state.version.store(next, std::memory_order_release);
+
+        unlockWriter();
+
+        wakeWaiters();
+    }
+
+    /**
+     * @brief Publishes the opened buffer @p idx, with dirty bits and callbacks for
+     *        what differs from @p current.
+     *
+     * Callers have already skipped writes that change nothing.
+     */
+    void commitWrite(int idx, const T& current) {
+        const T& next = m_state.buffers[idx].data;
+        const std::uint64_t changed = changedWatches(current, next);
+        if (m_saveHook.thunk) {
+            markDirty(changedFields(current, next));
+        }
+
+        publish(idx);
+        notifyChanged(changed, next);
+    }
+
+    /**
+     * @brief Closes the buffer opened by openNextBuffer() without publishing it;
+     *        its version stays 0, so the snapshot it held has left the history.
+     */
+    void abandon(int idx) {
+        Buffer& target = m_state.buffers[idx];
+        target.seq.store(target.seq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        unlockWriter();
+    }
+
+    void bumpVersion() {
+        m_state.version.fetch_add(1, std::memory_order_release);
+        wakeWaiters();
+    }
+
+    void wakeWaiters() {
+#if defined(CONFIGLY_HAS_FUTEX)
+        detail::futex_wake_all(m_state.version, m_state.versionSleepers, State::kProcessShareable);
+#elif defined(__cpp_lib_atomic_wait)
+        m_state.version.notify_all();
+#endif
+        if (m_waitHooks.notify) {
+            m_waitHooks.notify(m_waitHooks.context);
+        }
+    }
+
+    /**
+     * @brief Bitmask of the watch entries whose member bytes differ.
+     *
+     * One vectorized pass over sizeof(T) finds the differing bytes, and the
+     * offset-sorted watch table maps them to entries; an unchanged config costs
+     * just the pass, however many callbacks are registered.
+     */
+    [[nodiscard]] std::uint64_t changedWatches(const T& oldConfig, const T& newConfig) const {
+        const void* oldPtr = &oldConfig;
+        const void* newPtr = &newConfig;
+
+        std::uint64_t mask = 0;
+        size_t pos = detail::first_difference(oldPtr, newPtr, 0, sizeof(T));
+        for (size_t k = 0; k < m_watchCount && pos < sizeof(T); ++k) {
+            const size_t i = m_watchOrder[k];
+            const auto& watch = m_watches[i];
+            if (watch.subscribers == 0) {
+                continue;
+            }
+
+            const size_t end = watch.memberOffset + watch.memberSize;
+            if (pos < watch.memberOffset) {
+                // difference lies in a gap nobody watches, look again from this entry on
+                pos = detail::first_difference(oldPtr, newPtr, watch.memberOffset, sizeof(T));
+            }
+            if (pos < end) {
+                mask |= std::uint64_t{1} << i;
+                pos = detail::first_difference(oldPtr, newPtr, end, sizeof(T));
+            }
+        }
+        return mask;
+    }
+
+    /**
+     * @brief Index of the field whose bytes (or trailing padding) contain @p offset.
+     */
+    [[nodiscard]] static std::size_t fieldAt(size_t offset) {
+        const auto& layout = detail::field_layout<T>;
+        std::size_t lo = 0;
+        std::size_t hi = kTrackedFields;
+        while (hi - lo > 1) {
+            const std::size_t mid = (lo + hi) / 2;
+            if (layout[mid].offset <= offset) {
+                lo = mid;
+            } else {
+                hi = mid;
+            }
+        }
+        return lo;
+    }
+
+    /**
+     * @brief Bitmask of the fields whose bytes differ, same walk as changedWatches().
+     */
+    [[nodiscard]] static std::uint64_t changedFields(const T& oldConfig, const T& newConfig) {
+        const auto& layout = detail::field_layout<T>;
+        std::uint64_t mask = 0;
+        size_t pos = detail::first_difference(&oldConfig, &newConfig, 0, sizeof(T));
+        while (pos < sizeof(T)) {
+            const std::size_t field = fieldAt(pos);
+            mask |= std::uint64_t{1} << field;
+            if (field + 1 == kTrackedFields) {
+                break;
+            }
+            pos = detail::first_difference(&oldConfig, &newConfig, layout[field + 1].offset, sizeof(T));
+        }
+        return mask;
+    }
+
+    bool flushStaged(bool onlyIfDue) {
+        lockWriter();
+        const auto now = std::chrono::steady_clock::now();
+        if (m_stagedFields == 0 || (onlyIfDue && now - m_lastFlush < m_coalesceInterval)) {
+            unlockWriter();
+            return false;
+        }
+        m_lastFlush = now;
+
+        // current config plus the staged fields only, so writes from other
+        // instances to fields we did not touch survive; it is assembled in the
+        // staging copy, so a flush that changes nothing opens no buffer
+        const T& current = m_state.buffers[m_state.activeIndex.load(std::memory_order_relaxed)].data;
+        copyFields(~m_stagedFields, current, m_staged);
+        m_stagedFields = 0;
+        if (detail::first_difference(&current, &m_staged, 0, sizeof(T)) == sizeof(T)) {
+            unlockWriter();
+            m_stats.onSkippedPublish();
+            return true;
+        }
+
+        const int inactive_idx = openNextBuffer();
+        detail::copy_config(m_state.buffers[inactive_idx].data, m_staged);
+        commitWrite(inactive_idx, current);
+        return true;
+    }
+
+    /**
+     * @brief Copies the bytes of the fields in @p fields from @p from into @p to.
+     */
+    static void copyFields(std::uint64_t fields, const T& from, T& to) {
+        const auto& layout = detail::field_layout<T>;
+        for (std::size_t i = 0; i < kTrackedFields; ++i) {
+            if ((fields >> i) & 1u) {
+                const std::size_t end = i + 1 < kTrackedFields ? layout[i + 1].offset : sizeof(T);
+                std::memcpy(reinterpret_cast<char*>(&to) + layout[i].offset,
+                            reinterpret_cast<const char*>(&from) + layout[i].offset,
+                            end - layout[i].offset);
+            }
+        }
+    }
+
+    [[nodiscard]] bool isCoalescing() const {
+        return m_coalesceInterval.count() != 0;
+    }
+
+    /**
+     * @brief Applies @p stager to the staging copy under the writer lock.
+     *
+     * @p stager returns the fields it touched; the write is published right
+     * away if the coalescing interval has already elapsed.
+     */
+    template<typename Stager>
+    void stage(Stager&& stager) {
+        lockWriter();
+        if (m_stagedFields == 0) {
+            detail::copy_config(m_staged, m_state.buffers[m_state.activeIndex.load(std::memory_order_relaxed)].data);
+        }
+        m_stagedFields |= stager(m_staged);
+        const bool due = std::chrono::steady_clock::now() - m_lastFlush >= m_coalesceInterval;
+        unlockWriter();
+
+        if (due) {
+            flush();
+        }
+    }
+
+    void markDirty(std::uint64_t mask) {
+        if (mask != 0) {
+            m_dirtyFields.fetch_or(mask, std::memory_order_release);
+        }
+    }
+
+    /**
+     * @brief Runs or queues the callbacks in @p mask, depending on the dispatch mode.
+     */
+    void notifyChanged(std::uint64_t mask, const T& newConfig) {
+        if (mask == 0) {
+            return;
+        }
+        if (m_dispatchMode == configly::DispatchMode::Deferred) {
+            m_pendingWatches.fetch_or(mask, std::memory_order_release);
+        } else {
+            dispatchWatches(mask, newConfig);
+        }
+    }
+
+    /**
+     * @brief Runs every subscriber of the watch entries in @p mask once.
+     *
+     * Both loops only visit set bits, so the cost follows what changed and who
+     * listens to it, not MaxCallbacks.
+     */
+    size_t dispatchWatches(std::uint64_t mask, const T& newConfig) {
+        std::uint64_t subs = 0;
+        for (; mask != 0; mask &= mask - 1) {
+            subs |= m_watches[detail::ctz64(mask)].subscribers;
+        }
+
+        size_t count = 0;
+        for (; subs != 0; subs &= subs - 1) {
+            const auto& slot = m_subscribers[detail::ctz64(subs)];
+            if constexpr (Stats::kEnabled) {
+                const auto t0 = std::chrono::steady_clock::now();
+                slot.thunk(slot, newConfig);
+                const auto elapsed = std::chrono::steady_clock::now() - t0;
+                m_stats.onCallback(static_cast<std::uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+            } else {
+                slot.thunk(slot, newConfig);
+            }
+            ++count;
+        }
+        return count;
+    }
+
+    // --- Shared Members (buffers, index, version, lock, defaults) ---
+    State& m_state;
+
+    // --- Process-local Members ---
+
+    struct Subscriber {
+        void (*thunk)(const Subscriber&, const T&) = nullptr;
+        void* callback = nullptr;
+        void* context = nullptr;
+        size_t memberOffset = 0;
+    };
+
+    // one entry per distinct watched member, with a bit per subscriber
+    struct Watch {
+        size_t memberOffset = 0;
+        size_t memberSize = 0;
+        std::uint64_t subscribers = 0;
+    };
+
+    static constexpr std::size_t kMaxWatches =
+        std::min<std::size_t>(64, std::max(kFieldCount, MaxCallbacks));
+
+    std::array<Subscriber, MaxCallbacks> m_subscribers{};
+    std::array<Watch, kMaxWatches> m_watches{};
+    size_t m_watchCount = 0;
+    std::array<std::uint8_t, kMaxWatches> m_watchOrder{};   // watch indices sorted by memberOffset
+    std::array<std::uint8_t, kFieldCount> m_fieldWatches = detail::filled_array<kFieldCount>(kUnresolvedSlot);
+
+    template<typename MemberType>
+    static void memberThunk(const Subscriber& slot, const T& newConfig) {
+        const MemberType& typedValue = *reinterpret_cast<const MemberType*>(
+            reinterpret_cast<const char*>(&newConfig) + slot.memberOffset);
+        reinterpret_cast<void (*)(const MemberType&, void*)>(slot.callback)(typedValue, slot.context);
+    }
+
+    static void groupThunk(const Subscriber& slot, const T& newConfig) {
+        reinterpret_cast<void (*)(const T&, void*)>(slot.callback)(newConfig, slot.context);
+    }
+
+    struct SaveHook {
+        bool (*thunk)(const SaveHook&, const T&, std::uint64_t) = nullptr;
+        void* function = nullptr;
+        void* context = nullptr;
+    };
+
+    static bool plainSaveThunk(const SaveHook& hook, const T& cfg, std::uint64_t) {
+        return reinterpret_cast<bool (*)(const T&)>(hook.function)(cfg);
+    }
+
+    static bool contextSaveThunk(const SaveHook& hook, const T& cfg, std::uint64_t) {
+        return reinterpret_cast<bool (*)(const T&, void*)>(hook.function)(cfg, hook.context);
+    }
+
+    static bool incrementalSaveThunk(const SaveHook& hook, const T& cfg, std::uint64_t dirty) {
+        return reinterpret_cast<bool (*)(const T&, std::uint64_t, void*)>(hook.function)(
+            cfg, dirty, hook.context);
+    }
+
+    static bool plainLoadThunk(T& cfg, void* fn) {
+        return reinterpret_cast<bool (*)(T&)>(fn)(cfg);
+    }
+
+    SaveHook m_saveHook{};
+    bool (*m_loadUserConfig)(T&, void*) = nullptr;
+    void* m_loadContext = nullptr;
+
+    configly::DispatchMode m_dispatchMode = configly::DispatchMode::Immediate;
+    configly::WaitHooks m_waitHooks{};
+    alignas(detail::line_align<std::atomic<std::uint64_t>>) std::atomic<std::uint64_t> m_pendingWatches{0};
+    mutable std::atomic<std::uint64_t> m_dirtyFields{0};
+
+    // coalescing (guarded by the writer lock)
+    std::chrono::microseconds m_coalesceInterval{0};
+    std::chrono::steady_clock::time_point m_lastFlush{};
+    std::uint64_t m_stagedFields = 0;
+    T m_staged{};
+
+    // counters keep their own cache lines (see configly::AtomicStats)
+    mutable Stats m_stats;
+};
+
+namespace configly {
+    /**
+     * @brief A Configly that owns its state; any number of them can coexist.
+     *
+     * @code
+     * configly::Owned<Configly<AppConfig>> cfg;
+     * cfg.setDefault({...});
+     * @endcode
+     */
+    template<typename Cfg>
+    class Owned : private detail::owned_state<typename Cfg::State>, public Cfg {
+    public:
+        Owned()
+            : detail::owned_state<typename Cfg::State>(),
+              Cfg(this->m_ownedState) {}
+    };
+
+    /**
+     * @brief A Configly constant-initialized from compile-time defaults.
+     *
+     * The state (every buffer, the defaults, version 1) is built by the compiler
+     * and emitted as initialized data: no setDefault() copies at startup, and
+     * instance() is a plain static with no init guard. T must be a literal type;
+     * the Lock must be constexpr-constructible (SpinLock, NoLock).
+     *
+     * @code
+     * inline constexpr AppConfig kAppDefaults{115200, Parity::None, 3};
+     * using AppCfg = configly::Static<Configly<AppConfig>, kAppDefaults>;
+     *
+     * const auto baud = AppCfg::instance().get(&AppConfig::baud);
+     * @endcode
+     */
+    template<typename Cfg, const typename Cfg::Value& Defaults>
+    class Static : private detail::owned_state<typename Cfg::State>, public Cfg {
+    public:
+        constexpr Static()
+            : detail::owned_state<typename Cfg::State>{typename Cfg::State(Defaults)},
+              Cfg(this->m_ownedState) {}
+
+        /**
+         * @brief Process-wide instance for these defaults; no function-local static.
+         */
+        static Static& instance() noexcept {
+            return s_instance;
+        }
+
+    private:
+        static Static s_instance;
+    };
+
+    template<typename Cfg, const typename Cfg::Value& Defaults>
+    CONFIGLY_CONSTINIT Static<Cfg, Defaults> Static<Cfg, Defaults>::s_instance{};
+}
@@ -0,0 +1,293 @@
+#pragma once
+
+// C++20 coroutine front end for Configly change notification:
+//
+//   configly::ChangeStream stream(cfg, &postToLoop, &loop, &AppConfig::baud);
+//   std::uint32_t baud = co_await stream.changed(&AppConfig::baud);
+//
+// A suspended waiter is a node in an intrusive per-field list, living in the
+// coroutine frame: no heap, and nothing runs for it until its field changes.
+// Resumption is handed to an executor you supply, never run inline on the
+// writer (or on the dispatchPending() thread in Deferred mode).
+
+#if !defined(__cpp_impl_coroutine)
+#error "configly/coro.hpp needs C++20 coroutines"
+#endif
+
+#include "configly.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace configly {
+
+/**
+ * @brief Resumes the coroutines of one Configly when the fields they wait on change.
+ *
+ * The stream holds a single onAnyChange() subscription over the members given
+ * to the constructor. On a publish it asks diffSince() which fields changed
+ * since the version it handled last and only walks the waiter lists of those
+ * fields (all of them if that version already left the ring). Put the
+ * Configly in DispatchMode::Deferred to do even that walk on the thread that
+ * calls dispatchPending() instead of on the writer.
+ *
+ * A waiter resumes once its field's bytes differ from the value it waits to
+ * leave, so a change that is undone before the waiter is checked goes
+ * unnoticed. Passing the last value back in makes a loop lossless.
+ *
+ * Construct and destroy the stream during setup, like any other subscription.
+ * Every waiter must have resumed or been destroyed before the stream goes.
+ *
+ * @code
+ * void postToLoop(std::coroutine_handle<> h, void* loop) { static_cast<Loop*>(loop)->post(h); }
+ *
+ * configly::ChangeStream stream(cfg, &postToLoop, &loop, &AppConfig::baud, &AppConfig::parity);
+ *
+ * Task watchBaud() {
+ *     std::uint32_t baud = cfg.get(&AppConfig::baud);
+ *     for (;;) {
+ *         baud = co_await stream.changed(&AppConfig::baud, baud);
+ *         reopenPort(baud);
+ *     }
+ * }
+ * @endcode
+ */
+template<typename Cfg>
+class ChangeStream {
+public:
+    using T = typename Cfg::Value;
+
+    /// executor hook: must arrange for @p handle.resume() to run later, elsewhere
+    using Post = void (*)(std::coroutine_handle<> handle, void* context);
+
+private:
+    // a config the reflection cannot take apart is a single field
+    static constexpr std::size_t kFields = std::max<std::size_t>(detail::reflected_fields<T>(), 1);
+    static_assert(kFields > 0 && kFields <= 64, "ChangeStream tracks at most 64 fields");
+
+    struct Waiter {
+        Waiter* prev = nullptr;
+        Waiter* next = nullptr;
+        bool (*differs)(const Waiter&) = nullptr;
+        std::coroutine_handle<> handle;
+        std::size_t field = 0;
+        bool linked = false;
+    };
+
+public:
+    /**
+     * @brief Awaitable returned by changed(); use it right away with co_await.
+     */
+    template<typename MemberPtr>
+    class Awaiter : private Waiter {
+    public:
+        using Value = detail::member_type_t<T, MemberPtr>;
+
+        Awaiter(const Awaiter&) = delete;
+        Awaiter& operator=(const Awaiter&) = delete;
+
+        // a coroutine destroyed while suspended leaves its list here
+        ~Awaiter() {
+            if (this->linked) {
+                m_stream.cancel(*this);
+            }
+        }
+
+        bool await_ready() const noexcept { return false; }
+
+        bool await_suspend(std::coroutine_handle<> handle) {
+            this->handle = handle;
+            return m_stream.suspend(*this);
+        }
+
+        Value await_resume() const {
+            return m_stream.m_cfg.get(m_member);
+        }
+
+    private:
+        friend class ChangeStream;
+
+        Awaiter(ChangeStream& stream, MemberPtr member, std::size_t field, const Value& from)
+            : m_stream(stream), m_member(member), m_from(from) {
+            this->field = field;
+            this->differs = &differsThunk;
+        }
+
+        bool differsFrom(const Value& value) const {
+            return std::memcmp(&value, &m_from, sizeof(Value)) != 0;
+        }
+
+        static bool differsThunk(const Waiter& w) {
+            const Awaiter& self = static_cast<const Awaiter&>(w);
+            return self.differsFrom(self.m_stream.m_cfg.get(self.m_member));
+        }
+
+        ChangeStream& m_stream;
+        MemberPtr m_member;
+        Value m_from;
+    };
+
+    /**
+     * @brief Subscribes to @p members of @p cfg; changed() accepts only these.
+     */
+    template<typename... MemberPtrs>
+    ChangeStream(Cfg& cfg, Post post, void* context, MemberPtrs... members)
+        : m_cfg(cfg), m_post(post), m_context(context), m_seen(cfg.version()) {
+        static_assert(sizeof...(MemberPtrs) > 0, "At least one member required");
+        assert(post && "ChangeStream needs an executor");
+        m_covered = ((std::uint64_t{1} << fieldOf(members)) | ...);
+        m_cfg.onAnyChange(&onPublish, this, members...);
+    }
+
+    ChangeStream(const ChangeStream&) = delete;
+    ChangeStream& operator=(const ChangeStream&) = delete;
+
+    ~ChangeStream() {
+        m_cfg.removeAnyChange(&onPublish, this);
+        assert(m_waiting == 0 && "ChangeStream destroyed with suspended waiters");
+    }
+
+    /**
+     * @brief Awaits the next change of @p member; co_await yields its new value.
+     */
+    template<typename MemberPtr>
+    [[nodiscard]] Awaiter<MemberPtr> changed(MemberPtr member) {
+        return changed(member, m_cfg.get(member));
+    }
+
+    /**
+     * @brief Awaits @p member holding anything but @p from; does not suspend
+     *        if it already does.
+     */
+    template<typename MemberPtr>
+    [[nodiscard]] Awaiter<MemberPtr> changed(MemberPtr member,
+                                             const detail::member_type_t<T, MemberPtr>& from) {
+        static_assert(std::is_member_object_pointer<MemberPtr>::value, "Member pointer required");
+        const std::size_t field = fieldOf(member);
+        assert(((m_covered >> field) & 1u) && "member not given to the ChangeStream constructor");
+        return Awaiter<MemberPtr>(*this, member, field, from);
+    }
+
+    template<auto Member>
+    [[nodiscard]] Awaiter<decltype(Member)> changed() {
+        return changed(Member);
+    }
+
+    /**
+     * @brief Number of coroutines currently suspended on this stream.
+     */
+    [[nodiscard]] std::size_t waiting() const noexcept {
+        return m_waiting;
+    }
+
+private:
+    template<typename MemberPtr>
+    std::size_t fieldOf(MemberPtr member) const {
+        const auto& defaults = m_cfg.getDefault();
+        const std::size_t offset = reinterpret_cast<const char*>(&(defaults.*member)) -
+                                   reinterpret_cast<const char*>(&defaults);
+        std::size_t field = 0;
+        while (field + 1 < kFields && detail::field_layout<T>[field + 1].offset <= offset) {
+            ++field;
+        }
+        return field;
+    }
+
+    // false: the field already changed, the coroutine goes on without suspending
+    template<typename MemberPtr>
+    bool suspend(Awaiter<MemberPtr>& a) {
+        Waiter& w = a;
+        m_lock.lock();
+        // under the lock: a publish after this check runs wake() after the link
+        if (a.differsFrom(m_cfg.get(a.m_member))) {
+            m_lock.unlock();
+            return false;
+        }
+        Waiter*& head = m_heads[w.field];
+        w.prev = nullptr;
+        w.next = head;
+        if (head) {
+            head->prev = &w;
+        }
+        head = &w;
+        w.linked = true;
+        ++m_waiting;
+        m_lock.unlock();
+        return true;
+    }
+
+    void unlink(Waiter& w) {
+        if (w.prev) {
+            w.prev->next = w.next;
+        } else {
+            m_heads[w.field] = w.next;
+        }
+        if (w.next) {
+            w.next->prev = w.prev;
+        }
+        w.linked = false;
+        --m_waiting;
+    }
+
+    void cancel(Waiter& w) {
+        m_lock.lock();
+        if (w.linked) {
+            unlink(w);
+        }
+        m_lock.unlock();
+    }
+
+    static void onPublish(const T&, void* self) {
+        static_cast<ChangeStream*>(self)->wake();
+    }
+
+    // the published config is not used: with two writers it can be older than
+    // version(). Waiters are checked against live reads taken after m_seen, so
+    // whatever they did not see yet is in the next wake's diffSince(m_seen).
+    void wake() {
+        m_lock.lock();
+        const std::uint64_t seen = m_seen;
+        m_seen = m_cfg.version();
+        std::uint64_t fields = m_cfg.diffSince(seen) & m_covered;
+
+        // collect under the lock, post after it: a posted coroutine may
+        // resume (and free its node) at once
+        Waiter* ready = nullptr;
+        for (; fields != 0; fields &= fields - 1) {
+            for (Waiter* w = m_heads[detail::ctz64(fields)]; w != nullptr;) {
+                Waiter* next = w->next;
+                if (w->differs(*w)) {
+                    unlink(*w);
+                    w->next = ready;
+                    ready = w;
+                }
+                w = next;
+            }
+        }
+        m_lock.unlock();
+
+        while (ready != nullptr) {
+            Waiter* next = ready->next;
+            m_post(ready->handle, m_context);
+            ready = next;
+        }
+    }
+
+    Cfg& m_cfg;
+    Post m_post;
+    void* m_context;
+    std::uint64_t m_covered = 0;
+
+    SpinLock m_lock;
+    std::uint64_t m_seen;
+    std::size_t m_waiting = 0;
+    std::array<Waiter*, kFields> m_heads{};
+};
+
+} // namespace configly
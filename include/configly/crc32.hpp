@@ -0,0 +1,33 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace detail {
+    constexpr std::array<std::uint32_t, 256> make_crc32_table() {
+        std::array<std::uint32_t, 256> table{};
+        for (std::uint32_t i = 0; i < 256; ++i) {
+            std::uint32_t c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1u) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+            }
+            table[i] = c;
+        }
+        return table;
+    }
+
+    inline constexpr std::array<std::uint32_t, 256> crc32_table = make_crc32_table();
+
+    /**
+     * @brief Standard CRC-32 (IEEE 802.3). Pass a previous result as @p crc to chain blocks.
+     */
+    inline std::uint32_t crc32(const void* data, std::size_t size, std::uint32_t crc = 0) noexcept {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        crc = ~crc;
+        for (std::size_t i = 0; i < size; ++i) {
+            crc = crc32_table[(crc ^ p[i]) & 0xFFu] ^ (crc >> 8);
+        }
+        return ~crc;
+    }
+}
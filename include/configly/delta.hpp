@@ -0,0 +1,242 @@
+#pragma once
+
+// Optional delta replication for Configly: a source node encodes what changed
+// since a version it already shipped, replicas apply it in one publish.
+//
+// Wire format (native byte order, so every node must share T's layout):
+//
+//   [ DeltaHeader | offset u32, size u32, bytes | ... | crc32 of all before ]
+//
+// A patch with fromVersion 0 carries every field and can bring any replica up
+// to date; any other patch only applies on top of exactly fromVersion. Versions
+// are only compared within one source epoch: a source that restarts counts
+// from 1 again under a new epoch, and its first full patch resyncs replicas.
+
+#include "configly.hpp"
+#include "crc32.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace configly {
+
+inline constexpr std::uint32_t kDeltaMagic = 0x44474643u;  // "CFGD"
+
+struct DeltaHeader {
+    std::uint32_t magic;
+    std::uint32_t layout;         ///< hash of sizeof(T) and the field spans
+    std::uint64_t fromVersion;    ///< source version the patch is relative to, 0 = full
+    std::uint64_t toVersion;      ///< source version the patch brings a replica to
+    std::uint32_t records;
+    std::uint32_t epoch;          ///< source boot id, versions of different epochs are unrelated
+};
+
+/**
+ * @brief The source state a replica mirrors; what applyDelta() advances.
+ */
+struct DeltaSync {
+    std::uint64_t version = 0;    ///< source version mirrored, 0 = none yet
+    std::uint32_t epoch = 0;      ///< source epoch that version belongs to
+};
+
+/**
+ * @brief What applyDelta() did with a patch.
+ */
+enum class DeltaResult {
+    Applied,    ///< published, the replica is now at toVersion
+    Duplicate,  ///< the replica already is at toVersion
+    Stale,      ///< older than what the replica has from the same epoch
+    Gap,        ///< relative to a version or epoch the replica is not at: ask for a full patch
+    Invalid,    ///< truncated, corrupted or made for another layout
+    Rejected    ///< well formed, but the result fails the replica's configly::schema<T>
+};
+
+}
+
+namespace detail {
+    struct delta_record {
+        std::uint32_t offset;
+        std::uint32_t size;
+    };
+
+    template<typename T>
+    constexpr std::size_t field_count_of() {
+        return sizeof(field_layout<T>) / sizeof(field_layout<T>[0]);
+    }
+
+    // end of field i, trailing padding included
+    template<typename T>
+    std::size_t field_end(std::size_t i) {
+        return i + 1 < field_count_of<T>() ? field_layout<T>[i + 1].offset : sizeof(T);
+    }
+
+    template<typename T>
+    std::uint32_t delta_layout() {
+        const std::uint32_t size = static_cast<std::uint32_t>(sizeof(T));
+        std::uint32_t h = crc32(&size, sizeof(size));
+        for (const field_span& span : field_layout<T>) {
+            const std::uint32_t words[2] = {static_cast<std::uint32_t>(span.offset),
+                                            static_cast<std::uint32_t>(span.size)};
+            h = crc32(words, sizeof(words), h);
+        }
+        return h;
+    }
+
+    // writes the contiguous runs of fields in mask; false if out of room
+    template<typename T>
+    bool put_delta_records(const T& data, std::uint64_t mask, unsigned char* out,
+                           std::size_t capacity, std::size_t& used, std::uint32_t& records) {
+        constexpr std::size_t count = field_count_of<T>();
+        const unsigned char* src = reinterpret_cast<const unsigned char*>(&data);
+        used = 0;
+        records = 0;
+        for (std::size_t i = 0; i < count;) {
+            if (!((mask >> i) & 1u)) {
+                ++i;
+                continue;
+            }
+            const std::size_t begin = field_layout<T>[i].offset;
+            while (i < count && ((mask >> i) & 1u)) {
+                ++i;
+            }
+            const std::size_t end = field_end<T>(i - 1);
+
+            const delta_record rec{static_cast<std::uint32_t>(begin), static_cast<std::uint32_t>(end - begin)};
+            if (capacity - used < sizeof(rec) + rec.size) return false;
+            std::memcpy(out + used, &rec, sizeof(rec));
+            std::memcpy(out + used + sizeof(rec), src + begin, rec.size);
+            used += sizeof(rec) + rec.size;
+            ++records;
+        }
+        return true;
+    }
+}
+
+namespace configly {
+
+/**
+ * @brief Largest patch encodeDelta() can produce for T.
+ */
+template<typename T>
+constexpr std::size_t maxDeltaSize() {
+    return sizeof(DeltaHeader) + detail::field_count_of<T>() * sizeof(detail::delta_record) +
+           sizeof(T) + sizeof(std::uint32_t);
+}
+
+/**
+ * @brief Encodes the fields that changed in @p cfg since @p fromVersion.
+ *
+ * The changed fields come from Configly::diffSince(), so @p fromVersion must
+ * still be in the snapshot ring; if it is not (or is 0) a full patch is
+ * encoded instead. Bytes are copied straight from the live buffer and the
+ * whole patch describes one consistent version.
+ * @param epoch changes whenever the source's versions start over, e.g. a boot
+ *        counter or a random value drawn at startup; 0 suits a source whose
+ *        versions never restart.
+ * @return bytes written, 0 if @p capacity is too small (maxDeltaSize<T>() always fits)
+ */
+template<typename Cfg>
+std::size_t encodeDelta(const Cfg& cfg, std::uint64_t fromVersion, void* out, std::size_t capacity,
+                        std::uint32_t epoch = 0) {
+    using T = typename Cfg::Value;
+    constexpr std::size_t kFixed = sizeof(DeltaHeader) + sizeof(std::uint32_t);
+    unsigned char* p = static_cast<unsigned char*>(out);
+    if (capacity < kFixed) return 0;
+
+    DeltaHeader header{};
+    header.magic = kDeltaMagic;
+    header.layout = detail::delta_layout<T>();
+    header.epoch = epoch;
+
+    std::size_t payload = 0;
+    for (auto guard = cfg.view();; guard.retry()) {
+        // the version the viewed bytes were published as, validated with them
+        header.toVersion = guard.version();
+        const std::uint64_t mask = fromVersion != 0 ? cfg.diffSince(fromVersion) : ~std::uint64_t{0};
+        header.fromVersion = mask == ~std::uint64_t{0} ? 0 : fromVersion;
+
+        const bool fits = detail::put_delta_records(*guard, mask, p + sizeof(DeltaHeader),
+                                                    capacity - kFixed, payload, header.records);
+
+        // diffSince() diffed against the current config, so the viewed buffer
+        // must still be it: then the mask, the bytes and toVersion belong together
+        if (header.toVersion != 0 && guard.valid() && cfg.version() == header.toVersion) {
+            if (!fits) return 0;
+            break;
+        }
+    }
+
+    std::memcpy(p, &header, sizeof(header));
+    const std::size_t body = sizeof(DeltaHeader) + payload;
+    const std::uint32_t crc = detail::crc32(p, body);
+    std::memcpy(p + body, &crc, sizeof(crc));
+    return body + sizeof(crc);
+}
+
+/**
+ * @brief Applies a patch from encodeDelta() to @p cfg in a single publish.
+ *
+ * @param synced source version and epoch @p cfg currently mirrors; advanced to
+ *        the patch's toVersion and epoch when it is applied.
+ *
+ * Within one epoch patches apply in version order. A full patch from another
+ * epoch always applies, a relative one is a Gap. The patch is fully validated
+ * first; anything but Applied leaves @p cfg and @p synced untouched and
+ * publishes nothing.
+ */
+template<typename Cfg>
+DeltaResult applyDelta(Cfg& cfg, const void* data, std::size_t size, DeltaSync& synced) {
+    using T = typename Cfg::Value;
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    if (size < sizeof(DeltaHeader) + sizeof(std::uint32_t)) return DeltaResult::Invalid;
+
+    DeltaHeader header;
+    std::memcpy(&header, p, sizeof(header));
+    std::uint32_t crc;
+    std::memcpy(&crc, p + size - sizeof(crc), sizeof(crc));
+    if (header.magic != kDeltaMagic || header.layout != detail::delta_layout<T>() ||
+        crc != detail::crc32(p, size - sizeof(crc))) {
+        return DeltaResult::Invalid;
+    }
+
+    // bounds of every record before anything is written
+    const unsigned char* records = p + sizeof(DeltaHeader);
+    const std::size_t payload = size - sizeof(DeltaHeader) - sizeof(crc);
+    std::size_t pos = 0;
+    for (std::uint32_t r = 0; r < header.records; ++r) {
+        detail::delta_record rec;
+        if (payload - pos < sizeof(rec)) return DeltaResult::Invalid;
+        std::memcpy(&rec, records + pos, sizeof(rec));
+        if (rec.offset > sizeof(T) || rec.size > sizeof(T) - rec.offset ||
+            payload - pos - sizeof(rec) < rec.size) {
+            return DeltaResult::Invalid;
+        }
+        pos += sizeof(rec) + rec.size;
+    }
+    if (pos != payload) return DeltaResult::Invalid;
+
+    const bool sameEpoch = synced.version != 0 && header.epoch == synced.epoch;
+    if (sameEpoch && header.toVersion == synced.version) return DeltaResult::Duplicate;
+    if (sameEpoch && header.toVersion < synced.version) return DeltaResult::Stale;
+    if (header.fromVersion != 0 && (!sameEpoch || header.fromVersion != synced.version)) {
+        return DeltaResult::Gap;
+    }
+
+    const bool accepted = cfg.tryModify([&](T& config) {
+        unsigned char* dst = reinterpret_cast<unsigned char*>(&config);
+        for (std::size_t at = 0; at < payload;) {
+            detail::delta_record rec;
+            std::memcpy(&rec, records + at, sizeof(rec));
+            std::memcpy(dst + rec.offset, records + at + sizeof(rec), rec.size);
+            at += sizeof(rec) + rec.size;
+        }
+        return true;
+    });
+    if (!accepted) return DeltaResult::Rejected;
+    synced.version = header.toVersion;
+    synced.epoch = header.epoch;
+    return DeltaResult::Applied;
+}
+
+} // namespace configly
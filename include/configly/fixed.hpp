@@ -0,0 +1,249 @@
+#pragma once
+
+// Fixed-capacity inline containers for config structs.
+//
+// Both are trivially copyable and never allocate, so a T holding them is
+// still a valid Configly config. They track their live length and keep every
+// byte past it zero: equal contents are equal bytes (diffs stay exact), and
+// Configly copies only the live part (see copy_used_from()).
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <string_view>
+#include <type_traits>
+
+namespace configly {
+
+/**
+ * @brief NUL-terminated string of up to @p N chars stored inline.
+ */
+template<std::size_t N>
+class fixed_string {
+    static_assert(N > 0 && N < 0xFFFFFFFFu, "fixed_string capacity out of range");
+
+public:
+    using value_type = char;
+
+    constexpr fixed_string() noexcept = default;
+
+    /**
+     * @brief From a string literal (truncated to N chars), usable in constant
+     *        expressions. Runtime strings go through assign() or operator=.
+     *
+     * There is deliberately no converting constructor from const char* or
+     * std::string_view: it would make the field-counting reflection ambiguous.
+     */
+    template<std::size_t M>
+    constexpr fixed_string(const char (&s)[M]) noexcept {
+        std::size_t n = 0;
+        while (n < M && n < N && s[n] != '\0') {
+            m_data[n] = s[n];
+            ++n;
+        }
+        m_size = static_cast<std::uint32_t>(n);
+    }
+
+    fixed_string& operator=(const char* s) noexcept {
+        assign(s ? std::string_view(s) : std::string_view{});
+        return *this;
+    }
+
+    fixed_string& operator=(std::string_view s) noexcept {
+        assign(s);
+        return *this;
+    }
+
+    /**
+     * @brief Replaces the contents; @p s is truncated to N chars.
+     * @return false if it had to be truncated
+     */
+    bool assign(std::string_view s) noexcept {
+        const std::size_t n = s.size() < N ? s.size() : N;
+        const std::size_t old = size();
+        std::memmove(m_data, s.data(), n);
+        if (old > n) std::memset(m_data + n, 0, old - n);
+        m_data[n] = '\0';
+        m_size = static_cast<std::uint32_t>(n);
+        return n == s.size();
+    }
+
+    /**
+     * @brief Appends @p s, as much of it as fits; false if truncated.
+     */
+    bool append(std::string_view s) noexcept {
+        const std::size_t at = size();
+        const std::size_t room = N - at;
+        const std::size_t n = s.size() < room ? s.size() : room;
+        std::memcpy(m_data + at, s.data(), n);
+        m_size = static_cast<std::uint32_t>(at + n);
+        return n == s.size();
+    }
+
+    bool push_back(char c) noexcept { return append(std::string_view(&c, 1)); }
+
+    void clear() noexcept { assign({}); }
+
+    // the length is clamped, so a torn copy can never index past the storage
+    [[nodiscard]] constexpr std::size_t size() const noexcept { return m_size < N ? m_size : N; }
+    [[nodiscard]] static constexpr std::size_t capacity() noexcept { return N; }
+    [[nodiscard]] constexpr bool empty() const noexcept { return m_size == 0; }
+
+    [[nodiscard]] constexpr const char* c_str() const noexcept { return m_data; }
+    [[nodiscard]] constexpr const char* data() const noexcept { return m_data; }
+    [[nodiscard]] constexpr std::string_view view() const noexcept { return {m_data, size()}; }
+    constexpr operator std::string_view() const noexcept { return view(); }
+
+    constexpr char operator[](std::size_t i) const noexcept { return m_data[i]; }
+
+    /**
+     * @brief Copy that reads and writes only the live bytes of both strings.
+     *
+     * Safe on a @p src that is being overwritten (seqlock reads): the length is
+     * clamped, and the result is only trusted once the read validates.
+     */
+    void copy_used_from(const fixed_string& src) noexcept {
+        const std::size_t n = src.size();
+        const std::size_t old = size();
+        std::memcpy(m_data, src.m_data, n);
+        if (old > n) std::memset(m_data + n, 0, old - n);
+        m_data[n] = '\0';
+        m_size = static_cast<std::uint32_t>(n);
+    }
+
+    friend bool operator==(const fixed_string& a, const fixed_string& b) noexcept { return a.view() == b.view(); }
+    friend bool operator!=(const fixed_string& a, const fixed_string& b) noexcept { return !(a == b); }
+    friend bool operator==(const fixed_string& a, std::string_view b) noexcept { return a.view() == b; }
+    friend bool operator!=(const fixed_string& a, std::string_view b) noexcept { return a.view() != b; }
+    friend bool operator==(const fixed_string& a, const char* b) noexcept { return a.view() == std::string_view(b); }
+    friend bool operator!=(const fixed_string& a, const char* b) noexcept { return !(a == b); }
+
+private:
+    std::uint32_t m_size = 0;
+    char m_data[N + 1] = {};
+};
+
+/**
+ * @brief Vector of up to @p N trivially copyable elements stored inline.
+ *
+ * Element slots past size() hold zero bytes, not live objects.
+ */
+template<typename T, std::size_t N>
+class fixed_vector {
+    static_assert(std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>,
+                  "fixed_vector elements must be trivially copyable and default constructible");
+    static_assert(N > 0 && N < 0xFFFFFFFFu, "fixed_vector capacity out of range");
+
+public:
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    // value-initialized elements: zero-initialized first, padding included
+    constexpr fixed_vector() noexcept = default;
+
+    fixed_vector(std::initializer_list<T> values) noexcept : fixed_vector() {
+        assign(values.begin(), values.size());
+    }
+
+    /**
+     * @brief Replaces the contents with the first N of @p count values.
+     * @return false if some did not fit
+     */
+    bool assign(const T* values, std::size_t count) noexcept {
+        const std::size_t n = count < N ? count : N;
+        const std::size_t old = size();
+        std::memmove(static_cast<void*>(m_data), values, n * sizeof(T));
+        if (old > n) std::memset(static_cast<void*>(m_data + n), 0, (old - n) * sizeof(T));
+        m_size = static_cast<std::uint32_t>(n);
+        return n == count;
+    }
+
+    bool push_back(const T& value) noexcept {
+        if (m_size >= N) return false;
+        m_data[m_size++] = value;
+        return true;
+    }
+
+    void pop_back() noexcept {
+        if (m_size == 0) return;
+        --m_size;
+        std::memset(static_cast<void*>(m_data + m_size), 0, sizeof(T));
+    }
+
+    /**
+     * @brief Grows with value-initialized elements or shrinks; false beyond N.
+     */
+    bool resize(std::size_t count) noexcept {
+        if (count > N) return false;
+        const std::size_t old = size();
+        for (std::size_t i = old; i < count; ++i) m_data[i] = T{};
+        if (old > count) std::memset(static_cast<void*>(m_data + count), 0, (old - count) * sizeof(T));
+        m_size = static_cast<std::uint32_t>(count);
+        return true;
+    }
+
+    void clear() noexcept { resize(0); }
+
+    // the length is clamped, so a torn copy can never index past the storage
+    [[nodiscard]] constexpr std::size_t size() const noexcept { return m_size < N ? m_size : N; }
+    [[nodiscard]] static constexpr std::size_t capacity() noexcept { return N; }
+    [[nodiscard]] constexpr bool empty() const noexcept { return m_size == 0; }
+
+    T* data() noexcept { return m_data; }
+    constexpr const T* data() const noexcept { return m_data; }
+    iterator begin() noexcept { return m_data; }
+    iterator end() noexcept { return m_data + size(); }
+    constexpr const_iterator begin() const noexcept { return m_data; }
+    constexpr const_iterator end() const noexcept { return m_data + size(); }
+
+    T& operator[](std::size_t i) noexcept { return m_data[i]; }
+    constexpr const T& operator[](std::size_t i) const noexcept { return m_data[i]; }
+    T& front() noexcept { return m_data[0]; }
+    constexpr const T& front() const noexcept { return m_data[0]; }
+    T& back() noexcept { return m_data[size() - 1]; }
+    constexpr const T& back() const noexcept { return m_data[size() - 1]; }
+
+    /**
+     * @brief Copy that reads and writes only the live elements of both vectors.
+     *        Same seqlock contract as fixed_string::copy_used_from().
+     */
+    void copy_used_from(const fixed_vector& src) noexcept {
+        const std::size_t n = src.size();
+        const std::size_t old = size();
+        std::memcpy(static_cast<void*>(m_data), src.m_data, n * sizeof(T));
+        if (old > n) std::memset(static_cast<void*>(m_data + n), 0, (old - n) * sizeof(T));
+        m_size = static_cast<std::uint32_t>(n);
+    }
+
+    // bytewise: the zeroed tails make equal contents equal bytes
+    friend bool operator==(const fixed_vector& a, const fixed_vector& b) noexcept {
+        return a.size() == b.size() && std::memcmp(a.m_data, b.m_data, a.size() * sizeof(T)) == 0;
+    }
+    friend bool operator!=(const fixed_vector& a, const fixed_vector& b) noexcept { return !(a == b); }
+
+private:
+    std::uint32_t m_size = 0;
+    T m_data[N] = {};
+};
+
+} // namespace configly
+
+namespace detail {
+    template<typename F>
+    struct is_fixed_string : std::false_type {};
+    template<std::size_t N>
+    struct is_fixed_string<configly::fixed_string<N>> : std::true_type {};
+
+    template<typename F>
+    struct is_fixed_vector : std::false_type {};
+    template<typename T, std::size_t N>
+    struct is_fixed_vector<configly::fixed_vector<T, N>> : std::true_type {};
+
+    template<typename F>
+    inline constexpr bool is_fixed_string_v = is_fixed_string<F>::value;
+
+    template<typename F>
+    inline constexpr bool is_fixed_vector_v = is_fixed_vector<F>::value;
+}
@@ -0,0 +1,323 @@
+#pragma once
+
+// Optional wear-aware flash journal for Configly.
+//
+// The flash region is split into two banks of whole sectors. A bank holds
+//
+//   [ BankHeader | base image of T | record | record | ... | erased ]
+//
+// where each record is an (offset, bytes) delta against the base. save()
+// appends records only for the dirty fields whose bytes really changed. When
+// a bank is full, compaction writes the full image to the other bank with a
+// higher generation and the old bank is left alone until the next compaction.
+// load() takes the newest valid bank and replays its records in order.
+
+#include "configly.hpp"
+#include "crc32.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace configly {
+
+/**
+ * @brief Flash driver hooks. Addresses are relative to the start of the region.
+ *
+ * program() may only be asked to clear bits of erased memory, and every program
+ * starts at a multiple of programAlign (at most 16) with a size that is one too.
+ */
+struct FlashOps {
+    bool (*read)(void* context, std::uint32_t address, void* out, std::size_t size) = nullptr;
+    bool (*program)(void* context, std::uint32_t address, const void* data, std::size_t size) = nullptr;
+    bool (*erase)(void* context, std::uint32_t sectorAddress) = nullptr;
+    void* context = nullptr;
+    std::uint32_t sectorSize = 4096;
+    std::uint32_t sectorsPerBank = 1;
+    std::uint32_t programAlign = 4;
+};
+
+template<typename T>
+class FlashJournal {
+    static_assert(std::is_trivially_copyable_v<T>, "FlashJournal stores T as raw bytes");
+
+public:
+    static constexpr std::uint32_t kBankMagic = 0x4C4E524Au;   // "JRNL"
+    static constexpr std::uint32_t kRecordTag = 0x4A524543u;   // "CERJ"
+
+    struct BankHeader {
+        std::uint32_t magic;
+        std::uint32_t layoutVersion;
+        std::uint32_t size;
+        std::uint32_t crc;
+        std::uint64_t generation;
+        std::uint64_t reserved;
+    };
+
+    struct RecordHeader {
+        std::uint32_t tag;
+        std::uint32_t offset;
+        std::uint32_t size;
+        std::uint32_t crc;
+    };
+
+    explicit FlashJournal(const FlashOps& ops, std::uint32_t layoutVersion = 1)
+        : m_ops(ops), m_layoutVersion(layoutVersion) {
+        assert(ops.programAlign > 0 && ops.programAlign <= kMaxAlign);
+        assert(logStart() < bankSize() && "bank too small for the base image");
+    }
+
+    /**
+     * @brief Finds the newest valid bank and replays its log into @p out.
+     */
+    [[nodiscard]] bool load(T& out) {
+        mount();
+        if (m_bank < 0) return false;
+        std::memcpy(static_cast<void*>(&out), &m_image, sizeof(T));
+        return true;
+    }
+
+    /**
+     * @brief Appends the fields in @p dirtyFields that differ from what is stored.
+     *        Falls back to compaction when the log is full.
+     */
+    [[nodiscard]] bool save(const T& cfg, std::uint64_t dirtyFields = ~std::uint64_t{0}) {
+        mount();
+        if (m_bank < 0 || m_needsCompaction) {
+            return compact(cfg);
+        }
+
+        const auto& layout = detail::field_layout<T>;
+        constexpr std::size_t count = sizeof(layout) / sizeof(layout[0]);
+        const unsigned char* src = reinterpret_cast<const unsigned char*>(&cfg);
+        const unsigned char* img = reinterpret_cast<const unsigned char*>(&m_image);
+
+        // contiguous dirty fields that really changed become one record
+        std::size_t runBegin = 0;
+        std::size_t runEnd = 0;
+        for (std::size_t i = 0; i <= count; ++i) {
+            bool take = false;
+            std::size_t begin = 0;
+            std::size_t end = 0;
+            if (i < count && ((dirtyFields >> i) & 1u)) {
+                begin = layout[i].offset;
+                end = i + 1 < count ? layout[i + 1].offset : sizeof(T);
+                take = std::memcmp(src + begin, img + begin, end - begin) != 0;
+            }
+            if (take && runEnd == begin && runEnd != runBegin) {
+                runEnd = end;
+                continue;
+            }
+            if (runEnd != runBegin && !appendRecord(cfg, runBegin, runEnd)) {
+                return m_needsCompaction ? compact(cfg) : false;
+            }
+            runBegin = begin;
+            runEnd = take ? end : begin;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Writes @p cfg as the base image of the other bank, emptying the log.
+     */
+    [[nodiscard]] bool compact(const T& cfg) {
+        const int target = m_bank < 0 ? 0 : 1 - m_bank;
+        const std::uint32_t base = bankAddress(target);
+        for (std::uint32_t s = 0; s < m_ops.sectorsPerBank; ++s) {
+            if (!m_ops.erase(m_ops.context, base + s * m_ops.sectorSize)) return false;
+        }
+        if (!programPadded(base + alignUp(sizeof(BankHeader)), &cfg, sizeof(T))) return false;
+
+        // header last: a torn compaction leaves the old bank the newest valid one
+        BankHeader header{};
+        header.magic = kBankMagic;
+        header.layoutVersion = m_layoutVersion;
+        header.size = static_cast<std::uint32_t>(sizeof(T));
+        header.generation = m_generation + 1;
+        header.crc = detail::crc32(&cfg, sizeof(T));
+        if (!programPadded(base, &header, sizeof(header))) return false;
+
+        std::memcpy(static_cast<void*>(&m_image), &cfg, sizeof(T));
+        m_bank = target;
+        m_generation = header.generation;
+        m_writePos = logStart();
+        m_needsCompaction = false;
+        return true;
+    }
+
+    /**
+     * @brief Routes cfg.save() / cfg.load() through this journal.
+     */
+    template<typename Cfg>
+    void attach(Cfg& cfg) {
+        cfg.setSaveFunction(&saveThunk, this);
+        cfg.setLoadFunction(&loadThunk, this);
+    }
+
+    [[nodiscard]] std::uint64_t generation() const { return m_generation; }
+
+    /**
+     * @brief Bytes of the current bank taken by records.
+     */
+    [[nodiscard]] std::uint32_t logBytes() const {
+        return m_bank < 0 ? 0 : m_writePos - logStart();
+    }
+
+private:
+    static constexpr std::uint32_t kMaxAlign = 16;
+    static constexpr std::uint32_t kReplayChunk = 64;
+
+    static bool saveThunk(const T& cfg, std::uint64_t dirty, void* self) {
+        return static_cast<FlashJournal*>(self)->save(cfg, dirty);
+    }
+
+    static bool loadThunk(T& cfg, void* self) {
+        return static_cast<FlashJournal*>(self)->load(cfg);
+    }
+
+    std::uint32_t alignUp(std::size_t value) const {
+        const std::uint32_t a = m_ops.programAlign;
+        return static_cast<std::uint32_t>((value + a - 1) / a * a);
+    }
+
+    std::uint32_t bankSize() const { return m_ops.sectorSize * m_ops.sectorsPerBank; }
+    std::uint32_t bankAddress(int bank) const { return static_cast<std::uint32_t>(bank) * bankSize(); }
+    std::uint32_t logStart() const { return alignUp(alignUp(sizeof(BankHeader)) + sizeof(T)); }
+
+    static std::uint32_t recordCrc(const RecordHeader& rec, const void* data) {
+        const std::uint32_t crc = detail::crc32(&rec.offset, 2 * sizeof(std::uint32_t));
+        return detail::crc32(data, rec.size, crc);
+    }
+
+    // programs size bytes, the last partial unit padded with erased bytes
+    bool programPadded(std::uint32_t address, const void* data, std::size_t size) {
+        const std::size_t whole = size / m_ops.programAlign * m_ops.programAlign;
+        if (whole != 0 && !m_ops.program(m_ops.context, address, data, whole)) return false;
+        if (whole == size) return true;
+        unsigned char tail[kMaxAlign];
+        std::memset(tail, 0xFF, sizeof(tail));
+        std::memcpy(tail, static_cast<const unsigned char*>(data) + whole, size - whole);
+        return m_ops.program(m_ops.context, address + static_cast<std::uint32_t>(whole), tail,
+                             m_ops.programAlign);
+    }
+
+    bool appendRecord(const T& cfg, std::size_t begin, std::size_t end) {
+        RecordHeader rec{};
+        rec.tag = kRecordTag;
+        rec.offset = static_cast<std::uint32_t>(begin);
+        rec.size = static_cast<std::uint32_t>(end - begin);
+        const unsigned char* data = reinterpret_cast<const unsigned char*>(&cfg) + begin;
+        rec.crc = recordCrc(rec, data);
+
+        const std::uint32_t length = alignUp(sizeof(rec)) + alignUp(rec.size);
+        if (m_writePos + length > bankSize()) {
+            m_needsCompaction = true;
+            return false;
+        }
+        const std::uint32_t address = bankAddress(m_bank) + m_writePos;
+        if (!programPadded(address, &rec, sizeof(rec)) ||
+            !programPadded(address + alignUp(sizeof(rec)), data, rec.size)) {
+            // partially programmed: never append behind it
+            m_needsCompaction = true;
+            return false;
+        }
+        std::memcpy(reinterpret_cast<unsigned char*>(&m_image) + begin, data, rec.size);
+        m_writePos += length;
+        return true;
+    }
+
+    bool readHeader(int bank, BankHeader& header) const {
+        return m_ops.read(m_ops.context, bankAddress(bank), &header, sizeof(header)) &&
+               header.magic == kBankMagic && header.layoutVersion == m_layoutVersion &&
+               header.size == sizeof(T);
+    }
+
+    bool readBase(int bank, const BankHeader& header) {
+        return m_ops.read(m_ops.context, bankAddress(bank) + alignUp(sizeof(BankHeader)),
+                          &m_image, sizeof(T)) &&
+               detail::crc32(&m_image, sizeof(T)) == header.crc;
+    }
+
+    // CRC of a record's data, read back from flash through a bounded buffer
+    bool checkRecord(std::uint32_t address, const RecordHeader& rec) const {
+        unsigned char chunk[kReplayChunk];
+        std::uint32_t crc = detail::crc32(&rec.offset, 2 * sizeof(std::uint32_t));
+        for (std::uint32_t done = 0; done < rec.size;) {
+            const std::uint32_t n = std::min<std::uint32_t>(rec.size - done, kReplayChunk);
+            if (!m_ops.read(m_ops.context, address + done, chunk, n)) return false;
+            crc = detail::crc32(chunk, n, crc);
+            done += n;
+        }
+        return crc == rec.crc;
+    }
+
+    // records are checked before their bytes touch the image, so a torn one
+    // never leaves a half-applied field behind
+    void replay() {
+        unsigned char* img = reinterpret_cast<unsigned char*>(&m_image);
+        const std::uint32_t base = bankAddress(m_bank);
+        m_writePos = logStart();
+        while (m_writePos + sizeof(RecordHeader) <= bankSize()) {
+            RecordHeader rec{};
+            if (!m_ops.read(m_ops.context, base + m_writePos, &rec, sizeof(rec))) break;
+            if (rec.tag != kRecordTag) {
+                // erased space: end of the log
+                return;
+            }
+            const std::uint32_t length = alignUp(sizeof(rec)) + alignUp(rec.size);
+            const std::uint32_t data = base + m_writePos + alignUp(sizeof(rec));
+            if (rec.offset > sizeof(T) || rec.size > sizeof(T) - rec.offset ||
+                m_writePos + length > bankSize() || !checkRecord(data, rec)) {
+                break;
+            }
+            if (!m_ops.read(m_ops.context, data, img + rec.offset, rec.size) ||
+                recordCrc(rec, img + rec.offset) != rec.crc) {
+                // the flash changed between the two reads and the image is
+                // now mixed: mount again on the next call
+                m_bank = -1;
+                m_mounted = false;
+                return;
+            }
+            m_writePos += length;
+        }
+        // torn or unreadable tail: keep what replayed, rewrite the bank on next save
+        m_needsCompaction = true;
+    }
+
+    void mount() {
+        if (m_mounted) return;
+        m_mounted = true;
+
+        BankHeader headers[2]{};
+        const bool ok[2] = {readHeader(0, headers[0]), readHeader(1, headers[1])};
+        int order[2] = {0, 1};
+        if (ok[1] && (!ok[0] || headers[1].generation > headers[0].generation)) {
+            order[0] = 1;
+            order[1] = 0;
+        }
+        for (int bank : order) {
+            if (ok[bank] && readBase(bank, headers[bank])) {
+                m_bank = bank;
+                m_generation = headers[bank].generation;
+                replay();
+                return;
+            }
+        }
+        // the other bank may still hold a valid generation, never reuse it blindly
+        m_generation = ok[0] || ok[1] ? std::max(headers[0].generation, headers[1].generation) : 0;
+    }
+
+    FlashOps m_ops;
+    std::uint32_t m_layoutVersion;
+    T m_image{};
+    int m_bank = -1;
+    std::uint64_t m_generation = 0;
+    std::uint32_t m_writePos = 0;
+    bool m_mounted = false;
+    bool m_needsCompaction = false;
+};
+
+} // namespace configly
@@ -0,0 +1,668 @@
+#pragma once
+
+// Single-pass, allocation-free JSON and INI (incl. the flat TOML subset:
+// quoted strings, [a.b] tables, [x, y] arrays, # comments) loaders, driven by
+// the field names of configly/serialize.hpp.
+//
+// The load_*() functions parse into a scratch T outside the writer lock and
+// publish the result once; nothing is published if the text does not parse.
+
+#include "configly.hpp"
+#include "serialize.hpp"
+
+#include <cctype>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+
+#if defined(__has_include)
+#if __has_include(<sys/mman.h>) && __has_include(<fcntl.h>) && __has_include(<unistd.h>)
+#define CONFIGLY_HAS_MMAP_LOADER 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#endif
+
+namespace configly {
+    /**
+     * @brief Where parsing stopped and why (message points to a string literal).
+     */
+    struct ParseError {
+        std::size_t offset = 0;
+        const char* message = nullptr;
+    };
+
+    /**
+     * @brief What a loaded document is applied to: keys missing from the text
+     *        take their value from the defaults, or keep the current one.
+     */
+    enum class LoadBase { Defaults, Current };
+}
+
+namespace detail {
+    inline bool is_space(char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    inline std::string_view trim(std::string_view s) {
+        while (!s.empty() && is_space(s.front())) s.remove_prefix(1);
+        while (!s.empty() && is_space(s.back())) s.remove_suffix(1);
+        return s;
+    }
+
+    /**
+     * @brief Parses the whole of @p text as a scalar field value.
+     */
+    template<typename F>
+    bool parse_scalar(std::string_view text, F& out) {
+        const char* first = text.data();
+        const char* last = text.data() + text.size();
+        if (text.empty()) return false;
+        if constexpr (std::is_same_v<F, bool>) {
+            if (text == "true") { out = true; return true; }
+            if (text == "false") { out = false; return true; }
+            return false;
+        } else if constexpr (std::is_enum_v<F>) {
+            std::underlying_type_t<F> raw{};
+            if (!parse_scalar(text, raw)) return false;
+            out = static_cast<F>(raw);
+            return true;
+        } else if constexpr (std::is_floating_point_v<F>) {
+            if (text == "null" || text == "nan") {
+                out = std::numeric_limits<F>::quiet_NaN();
+                return true;
+            }
+            if (*first == '+') ++first;
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+            const auto res = std::from_chars(first, last, out);
+            return res.ec == std::errc() && res.ptr == last;
+#else
+            char buf[64];
+            const std::size_t n = static_cast<std::size_t>(last - first);
+            if (n >= sizeof(buf)) return false;
+            std::memcpy(buf, first, n);
+            buf[n] = '\0';
+            char* end = nullptr;
+            out = static_cast<F>(std::strtod(buf, &end));
+            return end == buf + n;
+#endif
+        } else if constexpr (std::is_same_v<F, char> || std::is_same_v<F, signed char> ||
+                             std::is_same_v<F, unsigned char>) {
+            int wide = 0;
+            if (!parse_scalar(text, wide) || wide < std::numeric_limits<F>::min() ||
+                wide > std::numeric_limits<F>::max()) {
+                return false;
+            }
+            out = static_cast<F>(wide);
+            return true;
+        } else {
+            if (*first == '+') ++first;
+            int base = 10;
+            if (last - first > 2 && first[0] == '0' && (first[1] == 'x' || first[1] == 'X')) {
+                first += 2;
+                base = 16;
+            }
+            const auto res = std::from_chars(first, last, out, base);
+            return res.ec == std::errc() && res.ptr == last;
+        }
+    }
+
+    // --- JSON ---
+
+    class json_reader {
+    public:
+        json_reader(std::string_view text) : m_begin(text.data()), m_p(text.data()), m_end(text.data() + text.size()) {}
+
+        bool fail(const char* message) {
+            if (!m_error) {
+                m_error = message;
+                m_errorAt = m_p;
+            }
+            return false;
+        }
+
+        void skipSpace() {
+            while (m_p != m_end && is_space(*m_p)) ++m_p;
+        }
+
+        bool consume(char c) {
+            skipSpace();
+            if (m_p != m_end && *m_p == c) {
+                ++m_p;
+                return true;
+            }
+            return false;
+        }
+
+        bool expect(char c, const char* message) {
+            return consume(c) || fail(message);
+        }
+
+        bool atEnd() {
+            skipSpace();
+            return m_p == m_end;
+        }
+
+        /**
+         * @brief Reads a string; the raw (still escaped) body is returned as a view.
+         */
+        bool rawString(std::string_view& out) {
+            if (!consume('"')) return fail("expected string");
+            const char* start = m_p;
+            while (m_p != m_end && *m_p != '"') {
+                if (*m_p == '\\' && ++m_p == m_end) break;
+                ++m_p;
+            }
+            if (m_p == m_end) return fail("unterminated string");
+            out = std::string_view(start, static_cast<std::size_t>(m_p - start));
+            ++m_p;
+            return true;
+        }
+
+        /**
+         * @brief Unescapes a string into @p out (NUL padded); fails if it does not fit.
+         */
+        template<std::size_t N>
+        bool string(char (&out)[N]) {
+            std::string_view raw;
+            if (!rawString(raw)) return false;
+            std::size_t n = 0;
+            for (std::size_t i = 0; i < raw.size(); ++i) {
+                const char c = raw[i];
+                if (c != '\\') {
+                    // plain bytes (UTF-8 included) are copied as is
+                    if (n == N) return fail("string too long for field");
+                    out[n++] = c;
+                    continue;
+                }
+                unsigned code = 0;
+                const char e = raw[++i];
+                switch (e) {
+                    case 'n': code = '\n'; break;
+                    case 't': code = '\t'; break;
+                    case 'r': code = '\r'; break;
+                    case 'b': code = '\b'; break;
+                    case 'f': code = '\f'; break;
+                    case 'u': {
+                        if (i + 4 >= raw.size() ||
+                            std::from_chars(raw.data() + i + 1, raw.data() + i + 5, code, 16).ptr !=
+                                raw.data() + i + 5) {
+                            return fail("bad \\u escape");
+                        }
+                        i += 4;
+                        break;
+                    }
+                    default: code = static_cast<unsigned char>(e); break;
+                }
+                // escaped code point to UTF-8 (surrogate pairs are not combined)
+                char bytes[3];
+                std::size_t len = 0;
+                if (code < 0x80) {
+                    bytes[len++] = static_cast<char>(code);
+                } else if (code < 0x800) {
+                    bytes[len++] = static_cast<char>(0xC0 | (code >> 6));
+                    bytes[len++] = static_cast<char>(0x80 | (code & 0x3F));
+                } else {
+                    bytes[len++] = static_cast<char>(0xE0 | (code >> 12));
+                    bytes[len++] = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                    bytes[len++] = static_cast<char>(0x80 | (code & 0x3F));
+                }
+                if (n + len > N) return fail("string too long for field");
+                std::memcpy(out + n, bytes, len);
+                n += len;
+            }
+            std::memset(out + n, 0, N - n);
+            return true;
+        }
+
+        /**
+         * @brief The text of a number / true / false / null token.
+         */
+        bool token(std::string_view& out) {
+            skipSpace();
+            const char* start = m_p;
+            while (m_p != m_end && (std::isalnum(static_cast<unsigned char>(*m_p)) || *m_p == '-' ||
+                                    *m_p == '+' || *m_p == '.')) {
+                ++m_p;
+            }
+            if (m_p == start) return fail("expected value");
+            out = std::string_view(start, static_cast<std::size_t>(m_p - start));
+            return true;
+        }
+
+        bool skipValue(int depth = 0) {
+            if (depth > 64) return fail("nesting too deep");
+            skipSpace();
+            if (m_p == m_end) return fail("expected value");
+            if (*m_p == '"') {
+                std::string_view ignored;
+                return rawString(ignored);
+            }
+            if (*m_p == '{' || *m_p == '[') {
+                const char close = *m_p == '{' ? '}' : ']';
+                ++m_p;
+                if (consume(close)) return true;
+                do {
+                    if (close == '}') {
+                        std::string_view key;
+                        if (!rawString(key) || !expect(':', "expected ':'")) return false;
+                    }
+                    if (!skipValue(depth + 1)) return false;
+                } while (consume(','));
+                return expect(close, "expected ',' or closing bracket");
+            }
+            std::string_view ignored;
+            return token(ignored);
+        }
+
+        std::size_t errorOffset() const {
+            return static_cast<std::size_t>((m_error ? m_errorAt : m_p) - m_begin);
+        }
+
+        const char* error() const { return m_error; }
+
+    private:
+        const char* m_begin;
+        const char* m_p;
+        const char* m_end;
+        const char* m_error = nullptr;
+        const char* m_errorAt = nullptr;
+    };
+
+    template<typename F>
+    bool read_json(json_reader& in, F& out);
+
+    template<typename F, std::size_t... Is>
+    bool read_json_member(json_reader& in, F& out, std::string_view key, std::index_sequence<Is...>) {
+        constexpr auto names = configly::field_names<F>();
+        auto fields = tie_fields<count_fields<F>()>(out);
+        bool ok = true;
+        const bool known = ((key == names[Is] ? (ok = read_json(in, std::get<Is>(fields)), true) : false) || ...);
+        // unknown keys are skipped, so newer files still load
+        return known ? ok : in.skipValue();
+    }
+
+    template<typename F>
+    bool read_json(json_reader& in, F& out) {
+        if constexpr (is_char_array_v<F>) {
+            return in.string(out);
+        } else if constexpr (is_fixed_string_v<F>) {
+            char text[F::capacity()];
+            if (!in.string(text)) return false;
+            out.assign(char_array_view(text));
+            return true;
+        } else if constexpr (is_fixed_vector_v<F>) {
+            // the array replaces the whole vector
+            if (!in.expect('[', "expected '['")) return false;
+            out.clear();
+            if (in.consume(']')) return true;
+            do {
+                typename F::value_type element{};
+                if (!read_json(in, element)) return false;
+                if (!out.push_back(element)) return in.fail("too many array elements");
+            } while (in.consume(','));
+            return in.expect(']', "expected ',' or ']'");
+        } else if constexpr (std::is_array_v<F>) {
+            if (!in.expect('[', "expected '['")) return false;
+            if (in.consume(']')) return true;
+            std::size_t i = 0;
+            do {
+                if (i == std::extent_v<F>) return in.fail("too many array elements");
+                if (!read_json(in, out[i++])) return false;
+            } while (in.consume(','));
+            return in.expect(']', "expected ',' or ']'");
+        } else if constexpr (is_record_v<F>) {
+            if (!in.expect('{', "expected '{'")) return false;
+            if (in.consume('}')) return true;
+            do {
+                std::string_view key;
+                if (!in.rawString(key) || !in.expect(':', "expected ':'")) return false;
+                if (!read_json_member(in, out, key, std::make_index_sequence<count_fields<F>()>{})) {
+                    return false;
+                }
+            } while (in.consume(','));
+            return in.expect('}', "expected ',' or '}'");
+        } else {
+            static_assert(is_scalar_field_v<F>, "field type has no JSON mapping");
+            std::string_view text;
+            if (!in.token(text)) return false;
+            return parse_scalar(text, out) || in.fail("bad value for field type");
+        }
+    }
+
+    // --- INI / TOML subset ---
+
+    template<typename F>
+    bool parse_ini_value(std::string_view text, F& out) {
+        if constexpr (is_char_array_v<F>) {
+            if (text.size() >= 2 && (text.front() == '"' || text.front() == '\'') && text.back() == text.front()) {
+                if (text.front() == '"') {
+                    // TOML basic string: same escapes as JSON
+                    json_reader in(text);
+                    return in.string(out) && in.atEnd();
+                }
+                text = text.substr(1, text.size() - 2);
+            }
+            if (text.size() > std::extent_v<F>) return false;
+            std::memcpy(out, text.data(), text.size());
+            std::memset(out + text.size(), 0, std::extent_v<F> - text.size());
+            return true;
+        } else if constexpr (is_fixed_string_v<F>) {
+            char buffer[F::capacity()];
+            if (!parse_ini_value(text, buffer)) return false;
+            out.assign(char_array_view(buffer));
+            return true;
+        } else if constexpr (is_fixed_vector_v<F>) {
+            if (text.size() >= 2 && text.front() == '[' && text.back() == ']') {
+                text = text.substr(1, text.size() - 2);
+            }
+            out.clear();
+            while (!trim(text).empty()) {
+                const std::size_t comma = text.find(',');
+                typename F::value_type element{};
+                if (!parse_ini_value(trim(text.substr(0, comma)), element) || !out.push_back(element)) {
+                    return false;
+                }
+                text = comma == std::string_view::npos ? std::string_view{} : text.substr(comma + 1);
+            }
+            return true;
+        } else if constexpr (std::is_array_v<F>) {
+            if (text.size() >= 2 && text.front() == '[' && text.back() == ']') {
+                text = text.substr(1, text.size() - 2);
+            }
+            std::size_t i = 0;
+            while (!trim(text).empty()) {
+                if (i == std::extent_v<F>) return false;
+                const std::size_t comma = text.find(',');
+                if (!parse_ini_value(trim(text.substr(0, comma)), out[i++])) return false;
+                text = comma == std::string_view::npos ? std::string_view{} : text.substr(comma + 1);
+            }
+            return true;
+        } else {
+            static_assert(is_scalar_field_v<F>, "field type has no INI mapping");
+            return parse_scalar(text, out);
+        }
+    }
+
+    /**
+     * @brief Drops a trailing "# comment" or "; comment": a '#' or ';' after
+     *        whitespace, outside quotes. Quoted strings may contain both.
+     */
+    inline std::string_view strip_comment(std::string_view value) {
+        char quote = 0;
+        char previous = ' ';  // last character outside quotes
+        for (std::size_t i = 0; i < value.size(); ++i) {
+            const char c = value[i];
+            if (quote != 0) {
+                if (quote == '"' && c == '\\') {
+                    ++i;
+                } else if (c == quote) {
+                    quote = 0;
+                }
+                continue;
+            }
+            if ((c == '#' || c == ';') && previous == ' ') {
+                return trim(value.substr(0, i));
+            }
+            // a quote only opens a string where a value starts, so "it's" stays text
+            if ((c == '"' || c == '\'') && (previous == ' ' || previous == '[' || previous == ',')) {
+                quote = c;
+            }
+            previous = c == '\t' ? ' ' : c;
+        }
+        return value;
+    }
+
+    inline std::string_view next_segment(std::string_view& path) {
+        const std::size_t dot = path.find('.');
+        const std::string_view head = trim(path.substr(0, dot));
+        path = dot == std::string_view::npos ? std::string_view{} : path.substr(dot + 1);
+        return head;
+    }
+
+    /**
+     * @brief Assigns @p value to the field at section path + key path.
+     * @return 1 assigned, 0 no such field, -1 bad value
+     */
+    template<typename F>
+    int assign_ini(F& obj, std::string_view section, std::string_view key, std::string_view value);
+
+    template<typename F, std::size_t... Is>
+    int assign_ini_field(F& obj, std::string_view name, std::string_view section, std::string_view key,
+                         std::string_view value, std::index_sequence<Is...>) {
+        constexpr auto names = configly::field_names<F>();
+        auto fields = tie_fields<count_fields<F>()>(obj);
+        int result = 0;
+        ([&] {
+            if (result != 0 || name != names[Is]) return;
+            auto& field = std::get<Is>(fields);
+            using Field = std::remove_cv_t<std::remove_reference_t<decltype(field)>>;
+            if constexpr (is_record_v<Field>) {
+                result = assign_ini(field, section, key, value);
+            } else {
+                result = section.empty() && key.empty() ? (parse_ini_value(value, field) ? 1 : -1) : 0;
+            }
+        }(), ...);
+        return result;
+    }
+
+    template<typename F>
+    int assign_ini(F& obj, std::string_view section, std::string_view key, std::string_view value) {
+        if (section.empty() && key.empty()) return 0;
+        const std::string_view name = !section.empty() ? next_segment(section) : next_segment(key);
+        return assign_ini_field(obj, name, section, key, value, std::make_index_sequence<count_fields<F>()>{});
+    }
+
+    template<typename T>
+    bool read_ini(std::string_view text, T& out, configly::ParseError* error) {
+        std::string_view section;
+        std::size_t pos = 0;
+        auto fail = [&](std::size_t at, const char* message) {
+            if (error) *error = {at, message};
+            return false;
+        };
+        while (pos < text.size()) {
+            std::size_t eol = text.find('\n', pos);
+            if (eol == std::string_view::npos) eol = text.size();
+            const std::size_t lineStart = pos;
+            const std::string_view line = trim(text.substr(pos, eol - pos));
+            pos = eol + 1;
+
+            if (line.empty() || line.front() == '#' || line.front() == ';') continue;
+            if (line.front() == '[') {
+                if (line.back() != ']') return fail(lineStart, "expected ']'");
+                section = trim(line.substr(1, line.size() - 2));
+                continue;
+            }
+            const std::size_t eq = line.find('=');
+            if (eq == std::string_view::npos) return fail(lineStart, "expected key = value");
+            std::string_view value = trim(line.substr(eq + 1));
+            value = strip_comment(value);
+            // unknown keys are ignored, so newer files still load
+            if (assign_ini(out, section, trim(line.substr(0, eq)), value) < 0) {
+                return fail(lineStart, "bad value for field type");
+            }
+        }
+        return true;
+    }
+}
+
+namespace configly {
+    /**
+     * @brief Parses a JSON document into @p out (missing keys keep their value).
+     */
+    template<typename T>
+    [[nodiscard]] bool parse_json(std::string_view text, T& out, ParseError* error = nullptr) {
+        detail::json_reader in(text);
+        const bool ok = detail::read_json(in, out) && (in.atEnd() || in.fail("trailing characters"));
+        if (!ok && error) {
+            *error = {in.errorOffset(), in.error()};
+        }
+        return ok;
+    }
+
+    /**
+     * @brief Parses INI / flat TOML into @p out (missing keys keep their value).
+     */
+    template<typename T>
+    [[nodiscard]] bool parse_ini(std::string_view text, T& out, ParseError* error = nullptr) {
+        return detail::read_ini(text, out, error);
+    }
+}
+
+namespace detail {
+    template<typename T>
+    bool check_schema(const T& config, configly::ParseError* error) {
+        const bool ok = configly::accepts(config);
+        if (!ok && error) {
+            *error = {0, "value rejected by schema"};
+        }
+        return ok;
+    }
+
+    /**
+     * @brief Parses into @p scratch without holding the writer lock, then
+     *        publishes it with one update().
+     *
+     * On LoadBase::Current a write that lands during the parse would be lost,
+     * so the publish is a compareAndUpdate() and the parse reruns on top of
+     * the newer config.
+     */
+    template<typename Cfg, typename T, typename Parse>
+    bool load_into(Cfg& cfg, T& scratch, configly::LoadBase base, configly::ParseError* error, Parse&& parse) {
+        if (base == configly::LoadBase::Defaults) {
+            scratch = cfg.getDefault();
+            return parse(scratch) && check_schema(scratch, error) && cfg.update(scratch);
+        }
+        for (;;) {
+            // version first: the copy is at least that new, so a write in
+            // between only costs a retry
+            const std::uint64_t seen = cfg.version();
+            cfg.getAll(scratch);
+            if (!parse(scratch) || !check_schema(scratch, error)) {
+                return false;
+            }
+            if (cfg.compareAndUpdate(seen, scratch)) {
+                return true;
+            }
+        }
+    }
+
+    /**
+     * @brief Loads through tryModify(): without a scratch T the text is parsed
+     *        in the opened buffer, under the writer lock.
+     */
+    template<typename Cfg, typename T, typename Parse>
+    bool load_locked(Cfg& cfg, configly::LoadBase base, configly::ParseError* error, Parse&& parse) {
+        return cfg.tryModify([&](T& target) {
+            if (base == configly::LoadBase::Defaults) {
+                target = cfg.getDefault();
+            }
+            return parse(target) && check_schema(target, error);
+        });
+    }
+
+    // first line that is neither blank nor a comment is a [section] or key = value
+    inline bool looks_like_ini(std::string_view text) {
+        while (!text.empty()) {
+            const std::size_t eol = text.find('\n');
+            const std::string_view line = trim(text.substr(0, eol));
+            text = eol == std::string_view::npos ? std::string_view{} : text.substr(eol + 1);
+            if (line.empty() || line.front() == '#' || line.front() == ';') continue;
+            return line.front() == '[' || line.find('=') != std::string_view::npos;
+        }
+        return false;
+    }
+}
+
+namespace configly {
+    /**
+     * @brief Parses @p text into the caller's @p scratch, outside the writer
+     *        lock, and publishes it once; on a parse error, or a result
+     *        configly::schema<T> rejects, nothing is published.
+     */
+    template<typename Cfg, typename T = typename Cfg::Value>
+    [[nodiscard]] bool load_json(Cfg& cfg, std::string_view text, T& scratch, LoadBase base = LoadBase::Defaults,
+                                 ParseError* error = nullptr) {
+        return detail::load_into(cfg, scratch, base, error, [&](T& out) { return parse_json(text, out, error); });
+    }
+
+    template<typename Cfg, typename T = typename Cfg::Value>
+    [[nodiscard]] bool load_ini(Cfg& cfg, std::string_view text, T& scratch, LoadBase base = LoadBase::Defaults,
+                                ParseError* error = nullptr) {
+        return detail::load_into(cfg, scratch, base, error, [&](T& out) { return parse_ini(text, out, error); });
+    }
+
+    /**
+     * @brief Same, with the scratch on the stack for a T of up to
+     *        CONFIGLY_STACK_EDIT_MAX bytes. A bigger T is parsed inside
+     *        tryModify(), holding the writer lock; pass a scratch to avoid that.
+     */
+    template<typename Cfg, typename T = typename Cfg::Value>
+    [[nodiscard]] bool load_json(Cfg& cfg, std::string_view text, LoadBase base = LoadBase::Defaults,
+                                 ParseError* error = nullptr) {
+        auto parse = [&](T& out) { return parse_json(text, out, error); };
+        if constexpr (sizeof(T) <= CONFIGLY_STACK_EDIT_MAX) {
+            T scratch;
+            return detail::load_into(cfg, scratch, base, error, parse);
+        } else {
+            return detail::load_locked<Cfg, T>(cfg, base, error, parse);
+        }
+    }
+
+    template<typename Cfg, typename T = typename Cfg::Value>
+    [[nodiscard]] bool load_ini(Cfg& cfg, std::string_view text, LoadBase base = LoadBase::Defaults,
+                                ParseError* error = nullptr) {
+        auto parse = [&](T& out) { return parse_ini(text, out, error); };
+        if constexpr (sizeof(T) <= CONFIGLY_STACK_EDIT_MAX) {
+            T scratch;
+            return detail::load_into(cfg, scratch, base, error, parse);
+        } else {
+            return detail::load_locked<Cfg, T>(cfg, base, error, parse);
+        }
+    }
+
+#if defined(CONFIGLY_HAS_MMAP_LOADER)
+    /**
+     * @brief Maps @p path read-only and loads it; JSON if the first non-blank
+     *        character is '{', INI / TOML if the first line that is not a
+     *        comment is a [section] or key = value.
+     * @return false for an empty file or one in neither format; nothing is published
+     */
+    template<typename Cfg>
+    [[nodiscard]] bool load_file(Cfg& cfg, const char* path, LoadBase base = LoadBase::Defaults,
+                                 ParseError* error = nullptr) {
+        const int fd = ::open(path, O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st {};
+        if (fstat(fd, &st) != 0) {
+            ::close(fd);
+            return false;
+        }
+        const std::size_t size = static_cast<std::size_t>(st.st_size);
+        void* mem = size ? mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0) : nullptr;
+        ::close(fd);
+        if (mem == MAP_FAILED) return false;
+
+        const std::string_view text(static_cast<const char*>(mem), size);
+        const std::string_view body = detail::trim(text);
+        bool ok = false;
+        if (!body.empty() && body.front() == '{') {
+            ok = load_json(cfg, text, base, error);
+        } else if (detail::looks_like_ini(body)) {
+            ok = load_ini(cfg, text, base, error);
+        } else if (error) {
+            *error = {0, body.empty() ? "empty file" : "neither JSON nor INI"};
+        }
+        if (mem) munmap(mem, size);
+        return ok;
+    }
+#endif
+}
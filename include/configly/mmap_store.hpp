@@ -0,0 +1,247 @@
+#pragma once
+
+// Optional memory-mapped persistence backend for Configly (POSIX only).
+//
+// File layout: two slots, each page aligned:
+//
+//   [ Header | image of T | pad to page ] [ Header | image of T | pad to page ]
+//
+// A save goes to the slot that is not current, so a crash in the middle of a
+// save leaves the previous image intact. Each header carries a generation and
+// a CRC of its image; load() takes the valid slot with the highest generation.
+
+#include "configly.hpp"
+#include "crc32.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace configly {
+
+template<typename T>
+class MappedStore {
+    static_assert(std::is_trivially_copyable_v<T>, "MappedStore stores T as raw bytes");
+
+public:
+    static constexpr std::uint32_t kMagic = 0x594C4643u; // "CFLY"
+
+    struct alignas(64) Header {
+        std::uint32_t magic;
+        std::uint32_t layoutVersion;
+        std::uint64_t size;
+        std::uint64_t generation;
+        std::uint32_t crc;
+    };
+
+    MappedStore() = default;
+    ~MappedStore() { close(); }
+
+    MappedStore(const MappedStore&) = delete;
+    MappedStore& operator=(const MappedStore&) = delete;
+
+    /**
+     * @brief Opens (or creates) the backing file and maps it.
+     * @param layoutVersion bump this whenever T changes; images with another
+     *        version are ignored by load().
+     */
+    [[nodiscard]] bool open(const char* path, std::uint32_t layoutVersion = 1) {
+        close();
+        const long page = sysconf(_SC_PAGESIZE);
+        m_pageSize = page > 0 ? static_cast<std::size_t>(page) : 4096;
+        m_slotSize = roundUp(sizeof(Header) + sizeof(T), m_pageSize);
+        m_layoutVersion = layoutVersion;
+
+        m_fd = ::open(path, O_RDWR | O_CREAT, 0644);
+        if (m_fd < 0) return false;
+
+        struct stat st {};
+        const off_t fileSize = static_cast<off_t>(2 * m_slotSize);
+        if (fstat(m_fd, &st) != 0 || (st.st_size < fileSize && ftruncate(m_fd, fileSize) != 0)) {
+            close();
+            return false;
+        }
+
+        void* mem = mmap(nullptr, 2 * m_slotSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+        if (mem == MAP_FAILED) {
+            close();
+            return false;
+        }
+        m_base = static_cast<unsigned char*>(mem);
+        m_current = newestSlot();
+        return true;
+    }
+
+    void close() {
+        if (m_base) {
+            munmap(m_base, 2 * m_slotSize);
+            m_base = nullptr;
+        }
+        if (m_fd >= 0) {
+            ::close(m_fd);
+            m_fd = -1;
+        }
+        m_current = -1;
+    }
+
+    [[nodiscard]] bool isOpen() const { return m_base != nullptr; }
+
+    /**
+     * @brief Generation of the image load() would return, 0 if there is none.
+     */
+    [[nodiscard]] std::uint64_t generation() const {
+        return m_current < 0 ? 0 : header(m_current).generation;
+    }
+
+    /**
+     * @brief Copies the newest valid image into @p out. No parsing involved.
+     */
+    [[nodiscard]] bool load(T& out) const {
+        if (m_current < 0) return false;
+        std::memcpy(static_cast<void*>(&out), image(m_current), sizeof(T));
+        return true;
+    }
+
+    /**
+     * @brief Writes @p cfg to the spare slot. Only the byte range that differs
+     *        from that slot is copied and synced, then the header is committed.
+     */
+    [[nodiscard]] bool save(const T& cfg) {
+        if (!m_base) return false;
+        if (m_current >= 0 && std::memcmp(image(m_current), &cfg, sizeof(T)) == 0) {
+            return true;
+        }
+        const int target = m_current < 0 ? 0 : 1 - m_current;
+        if (!writeImage(target, &cfg)) return false;
+        return commit(target);
+    }
+
+    /**
+     * @brief Saves a validated snapshot of @p cfg, taken before anything is
+     *        written, so the slot is written and synced once.
+     *
+     * A T of up to CONFIGLY_STACK_EDIT_MAX bytes is snapshotted on the stack
+     * and saved like save(const T&). A bigger T is copied by getAll() straight
+     * into the spare slot, skipping the stack copy, and its whole image is
+     * synced.
+     */
+    template<typename Cfg>
+    [[nodiscard]] bool save(const Cfg& cfg) {
+        if (!m_base) return false;
+        if constexpr (sizeof(T) <= CONFIGLY_STACK_EDIT_MAX) {
+            T snapshot;
+            cfg.getAll(snapshot);
+            return save(snapshot);
+        } else {
+            static_assert(alignof(T) <= alignof(Header), "the slot image must be aligned for T");
+            if (m_current >= 0) {
+                // read only: an unchanged config must not touch the spare slot,
+                // which still holds the previous generation
+                bool same = false;
+                for (auto guard = cfg.view();; guard.retry()) {
+                    same = std::memcmp(image(m_current), guard.get(), sizeof(T)) == 0;
+                    if (guard.valid()) break;
+                }
+                if (same) return true;
+            }
+            const int target = m_current < 0 ? 0 : 1 - m_current;
+            unsigned char* dst = image(target);
+            cfg.getAll(*reinterpret_cast<T*>(dst));
+            const std::size_t offset = static_cast<std::size_t>(dst - m_base);
+            if (!syncRange(offset, offset + sizeof(T))) return false;
+            return commit(target);
+        }
+    }
+
+    /**
+     * @brief Routes cfg.save() / cfg.load() through this store.
+     */
+    template<typename Cfg>
+    void attach(Cfg& cfg) {
+        cfg.setSaveFunction(&saveThunk, this);
+        cfg.setLoadFunction(&loadThunk, this);
+    }
+
+private:
+    static std::size_t roundUp(std::size_t value, std::size_t align) {
+        return (value + align - 1) / align * align;
+    }
+
+    static bool saveThunk(const T& cfg, void* self) {
+        return static_cast<MappedStore*>(self)->save(cfg);
+    }
+
+    static bool loadThunk(T& cfg, void* self) {
+        return static_cast<const MappedStore*>(self)->load(cfg);
+    }
+
+    unsigned char* slot(int index) const { return m_base + static_cast<std::size_t>(index) * m_slotSize; }
+    Header& header(int index) const { return *reinterpret_cast<Header*>(slot(index)); }
+    unsigned char* image(int index) const { return slot(index) + sizeof(Header); }
+
+    std::uint32_t checksum(int index, std::uint64_t generation) const {
+        const std::uint32_t crc = detail::crc32(&generation, sizeof(generation));
+        return detail::crc32(image(index), sizeof(T), crc);
+    }
+
+    bool valid(int index) const {
+        const Header& h = header(index);
+        return h.magic == kMagic && h.layoutVersion == m_layoutVersion && h.size == sizeof(T) &&
+               h.generation != 0 && h.crc == checksum(index, h.generation);
+    }
+
+    int newestSlot() const {
+        const bool a = valid(0);
+        const bool b = valid(1);
+        if (a && b) return header(1).generation > header(0).generation ? 1 : 0;
+        return a ? 0 : (b ? 1 : -1);
+    }
+
+    bool syncRange(std::size_t begin, std::size_t end) const {
+        const std::size_t first = begin / m_pageSize * m_pageSize;
+        return msync(m_base + first, roundUp(end, m_pageSize) - first, MS_SYNC) == 0;
+    }
+
+    // copies the dirty span [first, last] of src into the slot and syncs its pages
+    bool writeImage(int target, const void* src) {
+        unsigned char* dst = image(target);
+        const unsigned char* bytes = static_cast<const unsigned char*>(src);
+        const std::size_t first = detail::first_difference(dst, bytes, 0, sizeof(T));
+        if (first >= sizeof(T)) return true;
+        std::size_t last = sizeof(T);
+        while (last > first && dst[last - 1] == bytes[last - 1]) {
+            --last;
+        }
+        std::memcpy(dst + first, bytes + first, last - first);
+        const std::size_t offset = static_cast<std::size_t>(dst - m_base);
+        return syncRange(offset + first, offset + last);
+    }
+
+    bool commit(int target) {
+        Header& h = header(target);
+        h.magic = kMagic;
+        h.layoutVersion = m_layoutVersion;
+        h.size = sizeof(T);
+        h.generation = generation() + 1;
+        h.crc = checksum(target, h.generation);
+        const std::size_t offset = static_cast<std::size_t>(target) * m_slotSize;
+        if (!syncRange(offset, offset + sizeof(Header))) return false;
+        m_current = target;
+        return true;
+    }
+
+    int m_fd = -1;
+    unsigned char* m_base = nullptr;
+    std::size_t m_pageSize = 0;
+    std::size_t m_slotSize = 0;
+    std::uint32_t m_layoutVersion = 1;
+    int m_current = -1;
+};
+
+} // namespace configly
@@ -0,0 +1,407 @@
+#pragma once
+
+// Paged Configly for large configs (calibration tables and the like): T is
+// split into fixed-size pages and every page has its own small ring of the
+// usual seq + version buffers.
+//
+// A write copies and republishes only the pages it touches, and a read of a
+// field validates only the page(s) that field lives on, so neither costs
+// sizeof(T) and a reader of one page never retries because another changed.
+
+#include "configly.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+namespace configly {
+
+/**
+ * @brief Large-config variant of Configly with per-page seqlocks.
+ *
+ * Writers are serialized by one lock. A write opens the next buffer of each
+ * page it changes (copying that page only), then flips the pages' active
+ * indices in one short step bracketed by a flip seq. Reads inside one page
+ * use only that page's seq; reads that span pages (getAll(), a field across
+ * a page boundary) also check the flip seq, so they see every page from the
+ * same write.
+ *
+ * @code
+ * static configly::Paged<CalibrationTable> table;    // 4 KB pages
+ * table.setDefault(factoryTable);
+ * table.set(&CalibrationTable::gain, 1.5f);         // copies one page
+ * float gain = table.get(&CalibrationTable::gain);  // validates one page
+ * @endcode
+ */
+template<typename T, std::size_t PageSize = 4096, std::size_t Buffers = 2, typename Stats = NoStats,
+         typename Lock = SpinLock>
+class Paged {
+    static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
+    static_assert(PageSize >= 64 && (PageSize & (PageSize - 1)) == 0, "PageSize must be a power of two >= 64");
+    static_assert(Buffers >= 2, "every page needs at least two buffers");
+
+public:
+    using Value = T;
+
+    static constexpr std::size_t kPageSize = PageSize;
+    static constexpr std::size_t kPages = (sizeof(T) + PageSize - 1) / PageSize;
+
+    Paged() = default;
+    Paged(const Paged&) = delete;
+    Paged& operator=(const Paged&) = delete;
+
+    void setDefault(const T& defaults) {
+        m_defaults = defaults;
+        const unsigned char* src = reinterpret_cast<const unsigned char*>(&defaults);
+        const std::uint64_t next = m_version.load(std::memory_order_relaxed) + 1;
+
+        // every buffer of every page gets the defaults, no history
+        for (std::size_t p = 0; p < kPages; ++p) {
+            for (PageBuffer& buf : m_pages[p].buffers) {
+                buf.seq.store(0, std::memory_order_relaxed);
+                buf.version.store(0, std::memory_order_relaxed);
+                std::memcpy(buf.data.bytes, src + p * PageSize, pageBytes(p));
+            }
+            m_pages[p].buffers[0].version.store(next, std::memory_order_relaxed);
+            m_active[p].store(0, std::memory_order_relaxed);
+        }
+        m_version.store(next, std::memory_order_release);
+    }
+
+    [[nodiscard]] const T& getDefault() const {
+        return m_defaults;
+    }
+
+    /**
+     * @brief Reads one member; only the page(s) it lives on are validated.
+     */
+    template<typename MemberPtr>
+    [[nodiscard]] detail::member_type_t<T, MemberPtr> get(MemberPtr member) const {
+        static_assert(std::is_member_object_pointer<MemberPtr>::value, "Member pointer required");
+        detail::member_type_t<T, MemberPtr> value;
+        readRange(offsetOf(member), sizeof(value), reinterpret_cast<unsigned char*>(&value));
+        return value;
+    }
+
+    template<auto Member>
+    [[nodiscard]] auto get() const {
+        return get(Member);
+    }
+
+    /**
+     * @brief Consistent copy of the whole config, every page from the same write.
+     */
+    void getAll(T& out) const {
+        readRange(0, sizeof(T), reinterpret_cast<unsigned char*>(&out));
+    }
+
+    /**
+     * @brief Writes one member; copies and republishes only its page(s).
+     * @return false if configly::schema<T> rejects @p value; nothing is written
+     */
+    template<typename MemberPtr, typename ValueType>
+    bool set(MemberPtr member, ValueType&& value) {
+        static_assert(std::is_member_object_pointer<MemberPtr>::value, "Member pointer required");
+        return writeMember(member, std::forward<ValueType>(value), [member](const auto& v) {
+            return detail::member_ptr_accepts<T>(member, v, std::make_index_sequence<detail::rule_count<T>()>{});
+        });
+    }
+
+    template<auto Member, typename ValueType>
+    bool set(ValueType&& value) {
+        static_assert(std::is_member_object_pointer<decltype(Member)>::value, "Member pointer required");
+        return writeMember(Member, std::forward<ValueType>(value),
+                           [](const auto& v) { return configly::accepts<T, Member>(v); });
+    }
+
+    /**
+     * @brief Replaces the whole config; only the pages whose bytes differ are
+     *        copied and republished.
+     * @return false if configly::schema<T> rejects @p next; nothing is written
+     */
+    bool update(const T& next) {
+        m_stats.onUpdate();
+        if (!configly::accepts(next)) {
+            m_stats.onRejectedWrite();
+            return false;
+        }
+        const unsigned char* src = reinterpret_cast<const unsigned char*>(&next);
+
+        lockWriter();
+        std::array<int, kPages> opened;
+        bool changed = false;
+        for (std::size_t p = 0; p < kPages; ++p) {
+            const unsigned char* current = activeBuffer(p).data.bytes;
+            opened[p] = kUntouched;
+            if (detail::first_difference(current, src + p * PageSize, 0, pageBytes(p)) != pageBytes(p)) {
+                opened[p] = openPage(p);
+                std::memcpy(m_pages[p].buffers[opened[p]].data.bytes, src + p * PageSize, pageBytes(p));
+                changed = true;
+            }
+        }
+        if (!changed) {
+            m_lock.unlock();
+            m_stats.onSkippedPublish();
+            return true;
+        }
+        commit(opened, 0, kPages);
+        return true;
+    }
+
+    void restoreDefaults() {
+        update(m_defaults);
+    }
+
+    /**
+     * @brief Global version counter; incremented once per publish.
+     */
+    [[nodiscard]] std::uint64_t version() const {
+        return m_version.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Page holding the first byte of @p member.
+     */
+    template<typename MemberPtr>
+    [[nodiscard]] std::size_t pageOf(MemberPtr member) const {
+        return offsetOf(member) / PageSize;
+    }
+
+    /**
+     * @brief version() at which @p page was last republished; 0 before setDefault().
+     */
+    [[nodiscard]] std::uint64_t pageVersion(std::size_t page) const {
+        // no page carries a version until setDefault() has published them all
+        if (m_version.load(std::memory_order_acquire) == 0) {
+            return 0;
+        }
+        for (;;) {
+            const int idx = m_active[page].load(std::memory_order_acquire);
+            const std::uint64_t v = m_pages[page].buffers[idx].version.load(std::memory_order_acquire);
+            // 0 only while the page is being flipped to this buffer
+            if (v != 0) {
+                return v;
+            }
+        }
+    }
+
+    [[nodiscard]] std::uint64_t readRetries() const {
+        const StatsSnapshot s = m_stats.snapshot();
+        return s.readRetries + s.oddSeqSpins;
+    }
+
+    [[nodiscard]] StatsSnapshot stats() const {
+        return m_stats.snapshot();
+    }
+
+private:
+    struct PageData {
+        unsigned char bytes[PageSize];
+    };
+
+    // same buffer as Configly's ring: seq and version on the data's first line
+    using PageBuffer = typename SharedState<PageData, Buffers, Lock>::Buffer;
+
+    struct PageRing {
+        PageBuffer buffers[Buffers];
+    };
+
+    static constexpr int kUntouched = -1;
+
+    static constexpr std::size_t pageBytes(std::size_t page) {
+        return page + 1 < kPages ? PageSize : sizeof(T) - page * PageSize;
+    }
+
+    static constexpr int nextIndex(int idx) {
+        return idx + 1 == static_cast<int>(Buffers) ? 0 : idx + 1;
+    }
+
+    template<typename MemberPtr>
+    [[nodiscard]] std::size_t offsetOf(MemberPtr member) const {
+        return reinterpret_cast<const char*>(&(m_defaults.*member)) - reinterpret_cast<const char*>(&m_defaults);
+    }
+
+    // writer side only (lock held): the active buffers do not move
+    const PageBuffer& activeBuffer(std::size_t page) const {
+        return m_pages[page].buffers[m_active[page].load(std::memory_order_relaxed)];
+    }
+
+    /**
+     * @brief Copies bytes [offset, offset + size) of the current config.
+     *
+     * Inside one page only that page's seq is checked; across pages the flip
+     * seq must not move either, or the pages could come from different writes.
+     */
+    void readRange(std::size_t offset, std::size_t size, unsigned char* out) const {
+        const std::size_t first = offset / PageSize;
+        const std::size_t last = (offset + size - 1) / PageSize;
+        if (first == last) {
+            readPage(first, offset % PageSize, size, out);
+            return;
+        }
+
+        for (;;) {
+            const std::uint64_t flip = m_flip.load(std::memory_order_acquire);
+            if (flip & 1u) {
+                m_stats.onOddSeq();
+                continue;
+            }
+
+            std::size_t at = offset;
+            for (std::size_t p = first; p <= last; ++p) {
+                const std::size_t end = std::min(offset + size, (p + 1) * PageSize);
+                readPage(p, at % PageSize, end - at, out + (at - offset));
+                at = end;
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (m_flip.load(std::memory_order_relaxed) == flip) {
+                return;
+            }
+            m_stats.onReadRetry();
+        }
+    }
+
+    // the same seq protocol as Configly::view() + ReadGuard::valid(), on one page
+    void readPage(std::size_t page, std::size_t at, std::size_t size, unsigned char* out) const {
+        for (;;) {
+            const int idx = m_active[page].load(std::memory_order_acquire);
+            const PageBuffer& buf = m_pages[page].buffers[idx];
+            const std::uint64_t seq = buf.seq.load(std::memory_order_acquire);
+            if ((seq & 1u) || (buf.version.load(std::memory_order_acquire) == 0 &&
+                               m_active[page].load(std::memory_order_acquire) != idx)) {
+                m_stats.onOddSeq();
+                continue;
+            }
+
+            std::memcpy(out, buf.data.bytes + at, size);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (buf.seq.load(std::memory_order_acquire) == seq) {
+                return;
+            }
+            m_stats.onReadRetry();
+        }
+    }
+
+    template<typename MemberPtr, typename ValueType, typename Validator>
+    bool writeMember(MemberPtr member, ValueType&& value, Validator&& accepts) {
+        m_stats.onSet();
+        using M = detail::member_type_t<T, MemberPtr>;
+        const std::size_t offset = offsetOf(member);
+        const std::size_t first = offset / PageSize;
+        const std::size_t last = (offset + sizeof(M) - 1) / PageSize;
+
+        lockWriter();
+        M current;
+        copyActive(offset, sizeof(M), reinterpret_cast<unsigned char*>(&current));
+        M assigned = current;
+        assigned = std::forward<ValueType>(value);
+        if (!accepts(assigned)) {
+            m_lock.unlock();
+            m_stats.onRejectedWrite();
+            return false;
+        }
+        if (std::memcmp(&assigned, &current, sizeof(M)) == 0) {
+            m_lock.unlock();
+            m_stats.onSkippedPublish();
+            return true;
+        }
+
+        // copy-on-write of the touched pages only
+        std::array<int, kPages> opened;
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&assigned);
+        std::size_t at = offset;
+        for (std::size_t p = first; p <= last; ++p) {
+            opened[p] = openPage(p);
+            unsigned char* dst = m_pages[p].buffers[opened[p]].data.bytes;
+            std::memcpy(dst, activeBuffer(p).data.bytes, pageBytes(p));
+
+            const std::size_t end = std::min(offset + sizeof(M), (p + 1) * PageSize);
+            std::memcpy(dst + at % PageSize, bytes + (at - offset), end - at);
+            at = end;
+        }
+        commit(opened, first, last + 1);
+        return true;
+    }
+
+    void copyActive(std::size_t offset, std::size_t size, unsigned char* out) const {
+        for (std::size_t at = offset; at < offset + size;) {
+            const std::size_t p = at / PageSize;
+            const std::size_t end = std::min(offset + size, (p + 1) * PageSize);
+            std::memcpy(out + (at - offset), activeBuffer(p).data.bytes + at % PageSize, end - at);
+            at = end;
+        }
+    }
+
+    void lockWriter() {
+        const std::uint64_t spins = m_lock.lock();
+        if (spins != 0) {
+            m_stats.onLockSpins(spins);
+        }
+    }
+
+    /**
+     * @brief Opens the next buffer of @p page (seq odd); the caller fills it.
+     */
+    int openPage(std::size_t page) {
+        const int idx = nextIndex(m_active[page].load(std::memory_order_relaxed));
+        PageBuffer& buf = m_pages[page].buffers[idx];
+        buf.seq.store(buf.seq.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        buf.version.store(0, std::memory_order_relaxed);
+
+        // keep the data writes that follow from becoming visible before the odd seq
+        std::atomic_thread_fence(std::memory_order_release);
+        return idx;
+    }
+
+    /**
+     * @brief Closes the opened pages in [begin, end), flips them all to their new
+     *        buffers as one version and releases the writer lock.
+     */
+    void commit(const std::array<int, kPages>& opened, std::size_t begin, std::size_t end) {
+        for (std::size_t p = begin; p < end; ++p) {
+            if (opened[p] != kUntouched) {
+                PageBuffer& buf = m_pages[p].buffers[opened[p]];
+                buf.seq.store(buf.seq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+            }
+        }
+
+        const std::uint64_t next = m_version.load(std::memory_order_relaxed) + 1;
+        const std::uint64_t flip = m_flip.load(std::memory_order_relaxed);
+        m_flip.store(flip + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        // index before version, as in Configly::activate()
+        for (std::size_t p = begin; p < end; ++p) {
+            if (opened[p] != kUntouched) {
+                m_active[p].store(opened[p], std::memory_order_release);
+                m_pages[p].buffers[opened[p]].version.store(next, std::memory_order_release);
+            }
+        }
+
+        m_flip.store(flip + 2, std::memory_order_release);
+        m_version.store(next, std::memory_order_release);
+        m_lock.unlock();
+    }
+
+    std::array<PageRing, kPages> m_pages;
+
+    // read-mostly: one store per page per write that touches it
+    alignas(detail::line_align<std::atomic<int>>) std::array<std::atomic<int>, kPages> m_active{};
+
+    alignas(detail::line_align<std::atomic<std::uint64_t>>) std::atomic<std::uint64_t> m_flip{0};
+    std::atomic<std::uint64_t> m_version{0};
+
+    alignas(detail::line_align<Lock>) Lock m_lock;
+
+    T m_defaults{};
+    mutable Stats m_stats;
+};
+
+} // namespace configly
@@ -0,0 +1,129 @@
+#pragma once
+
+// Section-partitioned Configly: every top-level member of T is its own,
+// independently versioned Configly with its own buffer ring and seqs.
+
+#include "configly.hpp"
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace configly {
+
+/**
+ * @brief Splits T into sections, one per top-level member, discovered with the
+ *        same field reflection Configly uses for callbacks.
+ *
+ * A write to one section copies and publishes only that section, so it never
+ * invalidates readers of another one. getAll() assembles T section by section:
+ * each section is consistent on its own, the whole is not one snapshot.
+ *
+ * @code
+ * struct AppConfig { NetworkCfg network; MotorCfg motor; LogCfg logging; };
+ *
+ * configly::Partitioned<AppConfig> cfg;
+ * cfg.setDefault({...});
+ * cfg.section<&AppConfig::motor>().set(&MotorCfg::rpm, 1200);
+ * MotorCfg motor = cfg.getSection<&AppConfig::motor>();
+ * @endcode
+ */
+template<typename T, std::size_t Buffers = 2, typename Stats = NoStats, typename Lock = SpinLock>
+class Partitioned {
+public:
+    static constexpr std::size_t kSections = detail::count_fields<T>();
+    static_assert(kSections > 0, "T must be an aggregate whose members are the sections");
+
+    template<typename S>
+    using SectionConfig = Configly<S, detail::default_max_callbacks<S>(), Buffers, Stats, Lock>;
+
+    template<std::size_t I>
+    using Section = SectionConfig<detail::field_type_t<T, I>>;
+
+    Partitioned() = default;
+    Partitioned(const Partitioned&) = delete;
+    Partitioned& operator=(const Partitioned&) = delete;
+
+    /**
+     * @brief The Configly that holds section @p Member, for reads, writes and callbacks.
+     */
+    template<auto Member>
+    auto& section() {
+        return std::get<sectionIndex<Member>()>(m_sections);
+    }
+
+    template<auto Member>
+    const auto& section() const {
+        return std::get<sectionIndex<Member>()>(m_sections);
+    }
+
+    /**
+     * @brief Consistent copy of one section.
+     */
+    template<auto Member>
+    [[nodiscard]] detail::member_type_t<T, decltype(Member)> getSection() const {
+        detail::member_type_t<T, decltype(Member)> out;
+        section<Member>().getAll(out);
+        return out;
+    }
+
+    void setDefault(const T& defaults) {
+        forEach(defaults, [](auto& cfg, const auto& value) { cfg.setDefault(value); });
+    }
+
+    /**
+     * @brief Updates every section; each one publishes and fires callbacks on its own.
+     * @return false if some section's schema rejected its part; the other
+     *         sections are still updated
+     */
+    bool update(const T& config) {
+        bool accepted = true;
+        forEach(config, [&accepted](auto& cfg, const auto& value) { accepted &= cfg.update(value); });
+        return accepted;
+    }
+
+    /**
+     * @brief Copies every section into @p out (per-section consistency only).
+     */
+    void getAll(T& out) const {
+        getAllImpl(out, std::make_index_sequence<kSections>{});
+    }
+
+private:
+    template<auto Member>
+    static constexpr std::size_t sectionIndex() {
+        static_assert(std::is_member_object_pointer<decltype(Member)>::value,
+                      "Member pointer required");
+        constexpr std::size_t index = detail::field_index<T, Member>();
+        static_assert(index < kSections, "Member is not a top-level member of T");
+        return index;
+    }
+
+    template<typename Apply>
+    void forEach(const T& config, Apply&& apply) {
+        forEachImpl(config, apply, std::make_index_sequence<kSections>{});
+    }
+
+    template<typename Apply, std::size_t... Is>
+    void forEachImpl(const T& config, Apply& apply, std::index_sequence<Is...>) {
+        const auto fields = detail::tie_fields<kSections>(config);
+        (apply(std::get<Is>(m_sections), std::get<Is>(fields)), ...);
+    }
+
+    template<std::size_t... Is>
+    void getAllImpl(T& out, std::index_sequence<Is...>) const {
+        auto fields = detail::tie_fields<kSections>(out);
+        (std::get<Is>(m_sections).getAll(std::get<Is>(fields)), ...);
+    }
+
+    template<std::size_t... Is>
+    static auto makeStorage(std::index_sequence<Is...>)
+        -> std::tuple<Owned<Section<Is>>...>;
+
+    using Storage = decltype(makeStorage(std::make_index_sequence<kSections>{}));
+
+    Storage m_sections;
+};
+
+} // namespace configly
@@ -0,0 +1,495 @@
+#pragma once
+
+// Reflection-driven, allocation-free serializers for Configly structs.
+//
+//   - compact binary: fields packed in declaration order (nested structs
+//     flattened), framed by a layout hash and a CRC
+//   - JSON and INI writers (the matching parsers are in configly/loader.hpp)
+//
+// Field names come from CONFIGLY_REFLECT(Type, members...), or are recovered
+// from __PRETTY_FUNCTION__ in C++20 builds on GCC/Clang when no macro is given.
+
+#include "configly.hpp"
+#include "crc32.hpp"
+#include "fixed.hpp"
+
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace configly {
+    /**
+     * @brief Member names of T; specialized by CONFIGLY_REFLECT.
+     */
+    template<typename T>
+    struct reflect_names {
+        static constexpr bool kDefined = false;
+    };
+}
+
+namespace detail {
+    constexpr bool is_name_space(char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+
+    constexpr std::size_t count_names(std::string_view list) {
+        std::size_t count = list.empty() ? 0 : 1;
+        for (char c : list) {
+            count += c == ',' ? 1 : 0;
+        }
+        return count;
+    }
+
+    /**
+     * @brief Splits the stringized member list "a, b, c" of CONFIGLY_REFLECT.
+     */
+    template<std::size_t N>
+    constexpr std::array<std::string_view, N> split_names(std::string_view list) {
+        std::array<std::string_view, N> names{};
+        std::size_t pos = 0;
+        for (std::size_t i = 0; i < N; ++i) {
+            std::size_t end = list.find(',', pos);
+            if (end == std::string_view::npos) {
+                end = list.size();
+            }
+            std::size_t b = pos;
+            std::size_t e = end;
+            while (b < e && is_name_space(list[b])) ++b;
+            while (e > b && is_name_space(list[e - 1])) --e;
+            names[i] = list.substr(b, e - b);
+            pos = end + 1;
+        }
+        return names;
+    }
+
+#if __cplusplus >= 202002L && (defined(__GNUC__) || defined(__clang__))
+#define CONFIGLY_HAS_AUTO_NAMES 1
+    template<auto Ptr>
+    constexpr std::string_view pretty_name() {
+        return __PRETTY_FUNCTION__;
+    }
+
+    // GCC: "[with auto Ptr = (& reflection_object<S>.S::name)]"
+    // Clang: "[Ptr = &reflection_object<S>.name]"
+    constexpr std::string_view member_from_pretty(std::string_view pretty) {
+        const std::size_t open = pretty.find("Ptr = ");
+        std::size_t end = pretty.find_first_of(";]", open);
+        if (end != std::string_view::npos && end > 0 && pretty[end - 1] == ')') {
+            --end;
+        }
+        const std::size_t begin = pretty.find_last_of(".:", end) + 1;
+        return pretty.substr(begin, end - begin);
+    }
+
+    template<typename T, std::size_t I>
+    constexpr std::string_view auto_member_name() {
+        return member_from_pretty(pretty_name<&std::get<I>(
+            tie_fields<count_fields<T>()>(reflection_object<T>))>());
+    }
+
+    template<typename T, std::size_t... Is>
+    constexpr std::array<std::string_view, sizeof...(Is)> auto_names(std::index_sequence<Is...>) {
+        return {{auto_member_name<T, Is>()...}};
+    }
+#endif
+
+    template<typename F>
+    inline constexpr bool is_scalar_field_v = std::is_arithmetic_v<F> || std::is_enum_v<F>;
+
+    template<typename F>
+    inline constexpr bool is_record_v =
+        std::is_class_v<F> && std::is_aggregate_v<F> && count_fields<F>() > 0;
+
+    template<typename F>
+    inline constexpr bool is_char_array_v =
+        std::is_array_v<F> && std::rank_v<F> == 1 &&
+        std::is_same_v<std::remove_cv_t<std::remove_extent_t<F>>, char>;
+}
+
+namespace configly {
+    template<typename T>
+    constexpr bool has_field_names() {
+#if defined(CONFIGLY_HAS_AUTO_NAMES)
+        return reflect_names<T>::kDefined || detail::is_record_v<T>;
+#else
+        return reflect_names<T>::kDefined;
+#endif
+    }
+
+    /**
+     * @brief Declaration-order member names of T.
+     */
+    template<typename T>
+    constexpr auto field_names() {
+        static_assert(has_field_names<T>(),
+                      "no field names for T: add CONFIGLY_REFLECT(T, members...) or build as C++20");
+        if constexpr (reflect_names<T>::kDefined) {
+            return reflect_names<T>::names;
+        } else {
+#if defined(CONFIGLY_HAS_AUTO_NAMES)
+            return detail::auto_names<T>(std::make_index_sequence<detail::count_fields<T>()>{});
+#endif
+        }
+    }
+}
+
+/**
+ * @brief Declares the member names of an aggregate, in declaration order.
+ *        Use at global scope: CONFIGLY_REFLECT(AppConfig, baud, parity, name)
+ */
+#define CONFIGLY_REFLECT(Type, ...)                                                        \
+    template<>                                                                             \
+    struct configly::reflect_names<Type> {                                                 \
+        static_assert(::detail::count_names(#__VA_ARGS__) == ::detail::count_fields<Type>(), \
+                      "CONFIGLY_REFLECT must list every member of " #Type " in order");    \
+        static constexpr bool kDefined = true;                                             \
+        static constexpr auto names =                                                      \
+            ::detail::split_names<::detail::count_fields<Type>()>(#__VA_ARGS__);           \
+    }
+
+namespace detail {
+    // --- binary ---
+
+    template<typename F, std::size_t... Is>
+    constexpr std::size_t packed_size_fields(std::index_sequence<Is...>);
+
+    template<typename F, std::size_t... Is>
+    constexpr std::uint32_t layout_hash_fields(std::uint32_t h, std::index_sequence<Is...>);
+
+    template<typename F>
+    constexpr std::size_t packed_size() {
+        if constexpr (is_record_v<F>) {
+            return packed_size_fields<F>(std::make_index_sequence<count_fields<F>()>{});
+        } else {
+            return sizeof(F);
+        }
+    }
+
+    template<typename F, std::size_t... Is>
+    constexpr std::size_t packed_size_fields(std::index_sequence<Is...>) {
+        return (std::size_t{0} + ... + packed_size<field_type_t<F, Is>>());
+    }
+
+    constexpr std::uint32_t fnv1a(std::uint32_t h, std::uint32_t v) {
+        for (int i = 0; i < 4; ++i) {
+            h = (h ^ ((v >> (8 * i)) & 0xFFu)) * 16777619u;
+        }
+        return h;
+    }
+
+    /**
+     * @brief Hash of the flattened field sizes and nesting: changes whenever the
+     *        binary layout does.
+     */
+    template<typename F>
+    constexpr std::uint32_t layout_hash(std::uint32_t h = 2166136261u) {
+        if constexpr (is_record_v<F>) {
+            return layout_hash_fields<F>(fnv1a(h, '{'), std::make_index_sequence<count_fields<F>()>{});
+        } else {
+            return fnv1a(h, static_cast<std::uint32_t>(sizeof(F)));
+        }
+    }
+
+    template<typename F, std::size_t... Is>
+    constexpr std::uint32_t layout_hash_fields(std::uint32_t h, std::index_sequence<Is...>) {
+        ((h = layout_hash<field_type_t<F, Is>>(h)), ...);
+        return fnv1a(h, '}');
+    }
+
+    template<typename F>
+    void pack(const F& value, unsigned char*& out) {
+        if constexpr (is_record_v<F>) {
+            const auto fields = tie_fields<count_fields<F>()>(value);
+            std::apply([&out](const auto&... f) { (pack(f, out), ...); }, fields);
+        } else {
+            std::memcpy(out, &value, sizeof(F));
+            out += sizeof(F);
+        }
+    }
+
+    template<typename F>
+    void unpack(F& value, const unsigned char*& in) {
+        if constexpr (is_record_v<F>) {
+            auto fields = tie_fields<count_fields<F>()>(value);
+            std::apply([&in](auto&... f) { (unpack(f, in), ...); }, fields);
+        } else {
+            std::memcpy(static_cast<void*>(&value), in, sizeof(F));
+            in += sizeof(F);
+        }
+    }
+
+    inline void put_u32(unsigned char* out, std::uint32_t v) { std::memcpy(out, &v, sizeof(v)); }
+
+    inline std::uint32_t get_u32(const unsigned char* in) {
+        std::uint32_t v;
+        std::memcpy(&v, in, sizeof(v));
+        return v;
+    }
+
+    // --- text ---
+
+    /**
+     * @brief snprintf-style output: counts everything, stores what fits.
+     */
+    struct text_sink {
+        char* out;
+        std::size_t cap;
+        std::size_t len = 0;
+
+        void put(char c) {
+            if (len < cap) out[len] = c;
+            ++len;
+        }
+
+        void put(std::string_view s) {
+            for (char c : s) put(c);
+        }
+    };
+
+    template<typename F>
+    void put_number(text_sink& sink, F value) {
+        char buf[64];
+        if constexpr (std::is_floating_point_v<F>) {
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+            const auto res = std::to_chars(buf, buf + sizeof(buf), value);
+            sink.put(std::string_view(buf, static_cast<std::size_t>(res.ptr - buf)));
+#else
+            const int n = std::snprintf(buf, sizeof(buf), "%.17g", static_cast<double>(value));
+            sink.put(std::string_view(buf, n > 0 ? static_cast<std::size_t>(n) : 0));
+#endif
+        } else {
+            const auto res = std::to_chars(buf, buf + sizeof(buf), value);
+            sink.put(std::string_view(buf, static_cast<std::size_t>(res.ptr - buf)));
+        }
+    }
+
+    template<typename F>
+    void put_scalar(text_sink& sink, const F& value, bool json) {
+        if constexpr (std::is_same_v<F, bool>) {
+            sink.put(value ? "true" : "false");
+        } else if constexpr (std::is_enum_v<F>) {
+            put_number(sink, static_cast<std::underlying_type_t<F>>(value));
+        } else if constexpr (std::is_floating_point_v<F>) {
+            if (json && !(value == value && value - value == 0)) {
+                sink.put("null");  // NaN / Inf are not JSON
+            } else {
+                put_number(sink, value);
+            }
+        } else if constexpr (std::is_same_v<F, char> || std::is_same_v<F, signed char> ||
+                             std::is_same_v<F, unsigned char>) {
+            put_number(sink, static_cast<int>(value));
+        } else {
+            put_number(sink, value);
+        }
+    }
+
+    template<std::size_t N>
+    std::string_view char_array_view(const char (&s)[N]) {
+        std::size_t n = 0;
+        while (n < N && s[n] != '\0') ++n;
+        return {s, n};
+    }
+
+    inline void put_json_string(text_sink& sink, std::string_view s) {
+        static constexpr char kHex[] = "0123456789abcdef";
+        sink.put('"');
+        for (char c : s) {
+            const unsigned char u = static_cast<unsigned char>(c);
+            if (c == '"' || c == '\\') {
+                sink.put('\\');
+                sink.put(c);
+            } else if (u < 0x20) {
+                sink.put("\\u00");
+                sink.put(kHex[u >> 4]);
+                sink.put(kHex[u & 0xF]);
+            } else {
+                sink.put(c);
+            }
+        }
+        sink.put('"');
+    }
+
+    template<typename F>
+    void put_json(text_sink& sink, const F& value);
+
+    template<typename F, std::size_t... Is>
+    void put_json_object(text_sink& sink, const F& value, std::index_sequence<Is...>) {
+        constexpr auto names = configly::field_names<F>();
+        const auto fields = tie_fields<count_fields<F>()>(value);
+        sink.put('{');
+        ((sink.put(Is == 0 ? "\"" : ",\""), sink.put(names[Is]), sink.put("\":"),
+          put_json(sink, std::get<Is>(fields))), ...);
+        sink.put('}');
+    }
+
+    template<typename F>
+    void put_json(text_sink& sink, const F& value) {
+        if constexpr (is_char_array_v<F>) {
+            put_json_string(sink, char_array_view(value));
+        } else if constexpr (is_fixed_string_v<F>) {
+            put_json_string(sink, value.view());
+        } else if constexpr (is_fixed_vector_v<F>) {
+            sink.put('[');
+            for (std::size_t i = 0; i < value.size(); ++i) {
+                if (i != 0) sink.put(',');
+                put_json(sink, value[i]);
+            }
+            sink.put(']');
+        } else if constexpr (std::is_array_v<F>) {
+            sink.put('[');
+            for (std::size_t i = 0; i < std::extent_v<F>; ++i) {
+                if (i != 0) sink.put(',');
+                put_json(sink, value[i]);
+            }
+            sink.put(']');
+        } else if constexpr (is_record_v<F>) {
+            put_json_object(sink, value, std::make_index_sequence<count_fields<F>()>{});
+        } else {
+            static_assert(is_scalar_field_v<F>, "field type has no JSON mapping");
+            put_scalar(sink, value, true);
+        }
+    }
+
+    template<typename F>
+    void put_ini_value(text_sink& sink, const F& value) {
+        // strings are always quoted (TOML basic strings), so '#', ';' and
+        // edge blanks load back as they were
+        if constexpr (is_char_array_v<F>) {
+            put_json_string(sink, char_array_view(value));
+        } else if constexpr (is_fixed_string_v<F>) {
+            put_json_string(sink, value.view());
+        } else if constexpr (is_fixed_vector_v<F>) {
+            for (std::size_t i = 0; i < value.size(); ++i) {
+                if (i != 0) sink.put(',');
+                put_ini_value(sink, value[i]);
+            }
+        } else if constexpr (std::is_array_v<F>) {
+            for (std::size_t i = 0; i < std::extent_v<F>; ++i) {
+                if (i != 0) sink.put(',');
+                put_ini_value(sink, value[i]);
+            }
+        } else {
+            static_assert(is_scalar_field_v<F>, "field type has no INI mapping");
+            put_scalar(sink, value, false);
+        }
+    }
+
+    template<typename F>
+    void put_ini(text_sink& sink, const F& value, std::string_view section);
+
+    template<typename F, std::size_t... Is>
+    void put_ini_fields(text_sink& sink, const F& value, std::string_view section,
+                        std::index_sequence<Is...>) {
+        constexpr auto names = configly::field_names<F>();
+        const auto fields = tie_fields<count_fields<F>()>(value);
+        // plain keys first, then one [section] per nested struct
+        ([&] {
+            using Field = std::remove_cv_t<std::remove_reference_t<decltype(std::get<Is>(fields))>>;
+            if constexpr (!is_record_v<Field>) {
+                sink.put(names[Is]);
+                sink.put('=');
+                put_ini_value(sink, std::get<Is>(fields));
+                sink.put('\n');
+            }
+        }(), ...);
+        ([&] {
+            using Field = std::remove_cv_t<std::remove_reference_t<decltype(std::get<Is>(fields))>>;
+            if constexpr (is_record_v<Field>) {
+                char path[128];
+                std::size_t n = 0;
+                for (char c : section) if (n < sizeof(path)) path[n++] = c;
+                if (!section.empty() && n < sizeof(path)) path[n++] = '.';
+                for (char c : names[Is]) if (n < sizeof(path)) path[n++] = c;
+                put_ini(sink, std::get<Is>(fields), std::string_view(path, n));
+            }
+        }(), ...);
+    }
+
+    template<typename F>
+    void put_ini(text_sink& sink, const F& value, std::string_view section) {
+        if (!section.empty()) {
+            sink.put('[');
+            sink.put(section);
+            sink.put("]\n");
+        }
+        put_ini_fields(sink, value, section, std::make_index_sequence<count_fields<F>()>{});
+    }
+}
+
+namespace configly {
+    /**
+     * @brief Size of the binary image of T: 12-byte header, packed fields, CRC.
+     */
+    template<typename T>
+    constexpr std::size_t binary_size() {
+        return 3 * sizeof(std::uint32_t) + detail::packed_size<T>() + sizeof(std::uint32_t);
+    }
+
+    inline constexpr std::uint32_t kBinaryMagic = 0x42474643u;  // "CFGB"
+
+    /**
+     * @brief Writes the compact binary image of @p cfg.
+     * @return bytes written, 0 if @p capacity is below binary_size<T>()
+     */
+    template<typename T>
+    std::size_t write_binary(const T& cfg, void* out, std::size_t capacity) {
+        constexpr std::size_t payload = detail::packed_size<T>();
+        if (capacity < binary_size<T>()) return 0;
+        unsigned char* p = static_cast<unsigned char*>(out);
+        detail::put_u32(p, kBinaryMagic);
+        detail::put_u32(p + 4, detail::layout_hash<T>());
+        detail::put_u32(p + 8, static_cast<std::uint32_t>(payload));
+        unsigned char* fields = p + 12;
+        detail::pack(cfg, fields);
+        detail::put_u32(fields, detail::crc32(p + 12, payload));
+        return binary_size<T>();
+    }
+
+    /**
+     * @brief Reads an image written by write_binary(); @p cfg is untouched on failure.
+     */
+    template<typename T>
+    [[nodiscard]] bool read_binary(T& cfg, const void* in, std::size_t size) {
+        constexpr std::size_t payload = detail::packed_size<T>();
+        const unsigned char* p = static_cast<const unsigned char*>(in);
+        if (size < binary_size<T>() || detail::get_u32(p) != kBinaryMagic ||
+            detail::get_u32(p + 4) != detail::layout_hash<T>() || detail::get_u32(p + 8) != payload ||
+            detail::get_u32(p + 12 + payload) != detail::crc32(p + 12, payload)) {
+            return false;
+        }
+        T staged = cfg;
+        const unsigned char* fields = p + 12;
+        detail::unpack(staged, fields);
+        cfg = staged;
+        return true;
+    }
+
+    /**
+     * @brief Writes @p cfg as one-line JSON. Behaves like snprintf without the
+     *        terminator: returns the full length, stores at most @p capacity chars.
+     */
+    template<typename T>
+    std::size_t write_json(const T& cfg, char* out, std::size_t capacity) {
+        detail::text_sink sink{out, capacity};
+        detail::put_json(sink, cfg);
+        return sink.len;
+    }
+
+    /**
+     * @brief Writes @p cfg as INI: `key=value` lines, nested structs as
+     *        `[a.b]` sections, arrays comma separated, strings double-quoted.
+     *        Same contract as write_json().
+     */
+    template<typename T>
+    std::size_t write_ini(const T& cfg, char* out, std::size_t capacity) {
+        detail::text_sink sink{out, capacity};
+        detail::put_ini(sink, cfg, {});
+        return sink.len;
+    }
+}
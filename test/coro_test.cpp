@@ -0,0 +1,187 @@
+#include <gtest/gtest.h>
+#include <configly/configly.hpp>
+#include <configly/coro.hpp>
+#include <atomic>
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <thread>
+#include <vector>
+
+// --- Struttura di test ---
+struct CoroConfig {
+    uint32_t baud;
+    int parity;
+    int gain;
+};
+
+// --- Executor e task minimali ---
+struct ManualLoop {
+    std::deque<std::coroutine_handle<>> queue;
+
+    static void post(std::coroutine_handle<> h, void* self) {
+        static_cast<ManualLoop*>(self)->queue.push_back(h);
+    }
+
+    size_t run() {
+        size_t n = 0;
+        while (!queue.empty()) {
+            auto h = queue.front();
+            queue.pop_front();
+            h.resume();
+            ++n;
+        }
+        return n;
+    }
+};
+
+struct Task {
+    struct promise_type {
+        Task get_return_object() { return {std::coroutine_handle<promise_type>::from_promise(*this)}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+using Cfg = configly::Owned<Configly<CoroConfig>>;
+
+Task watchBaud(Cfg& config, configly::ChangeStream<Cfg>& stream, std::vector<uint32_t>& seen, int count) {
+    uint32_t baud = config.get(&CoroConfig::baud);
+    for (int i = 0; i < count; ++i) {
+        baud = co_await stream.changed(&CoroConfig::baud, baud);
+        seen.push_back(baud);
+    }
+}
+
+Task waitParity(configly::ChangeStream<Cfg>& stream, int& resumed) {
+    co_await stream.changed<&CoroConfig::parity>();
+    ++resumed;
+}
+
+// --- Test Suite per il change stream a coroutine ---
+TEST(ConfiglyCoroTest, ResumesOnExecutorOnlyForItsField) {
+    Cfg config;
+    config.setDefault({9600, 0, 0});
+    ManualLoop loop;
+    configly::ChangeStream stream(config, &ManualLoop::post, &loop, &CoroConfig::baud, &CoroConfig::parity);
+
+    std::vector<uint32_t> seen;
+    Task task = watchBaud(config, stream, seen, 2);
+    ASSERT_EQ(stream.waiting(), 1u);
+
+    config.set(&CoroConfig::gain, 5);      // campo non osservato
+    config.set(&CoroConfig::parity, 1);    // campo di un altro waiter
+    ASSERT_TRUE(loop.queue.empty());
+
+    config.set(&CoroConfig::baud, 19200u);
+    ASSERT_TRUE(seen.empty());             // non ripreso inline sul writer
+    ASSERT_EQ(loop.run(), 1u);
+    ASSERT_EQ(seen, std::vector<uint32_t>{19200});
+
+    // un cambio tra la ripresa e il co_await successivo non va perso
+    config.set(&CoroConfig::baud, 57600u);
+    loop.run();
+    ASSERT_EQ(seen, (std::vector<uint32_t>{19200, 57600}));
+    ASSERT_TRUE(task.handle.done());
+    task.handle.destroy();
+}
+
+TEST(ConfiglyCoroTest, ManyWaitersAndDeferredDispatch) {
+    Cfg config;
+    config.setDefault({9600, 0, 0});
+    config.setDispatchMode(configly::DispatchMode::Deferred);
+    ManualLoop loop;
+    configly::ChangeStream stream(config, &ManualLoop::post, &loop, &CoroConfig::parity);
+
+    int resumed = 0;
+    std::vector<Task> tasks;
+    for (int i = 0; i < 1000; ++i) {
+        tasks.push_back(waitParity(stream, resumed));
+    }
+    ASSERT_EQ(stream.waiting(), 1000u);
+
+    config.set(&CoroConfig::parity, 2);
+    ASSERT_TRUE(loop.queue.empty());       // nulla finche' non si fa dispatch
+    config.dispatchPending();
+    ASSERT_EQ(stream.waiting(), 0u);
+    ASSERT_EQ(loop.run(), 1000u);
+    ASSERT_EQ(resumed, 1000);
+
+    // una coroutine distrutta mentre e' sospesa esce dalla lista
+    Task pending = waitParity(stream, resumed);
+    ASSERT_EQ(stream.waiting(), 1u);
+    pending.handle.destroy();
+    ASSERT_EQ(stream.waiting(), 0u);
+
+    for (Task& t : tasks) {
+        t.handle.destroy();
+    }
+}
+
+// --- Test Suite per due writer concorrenti ---
+struct RaceConfig {
+    int pre;      // callback che gira prima dello stream
+    uint32_t baud;
+    int parity;
+    int post;     // callback che gira dopo lo stream
+};
+
+using RaceCfg = configly::Owned<Configly<RaceConfig>>;
+
+struct RaceSteps {
+    std::atomic<int> step{0};
+
+    void reach(int s) { step.store(s, std::memory_order_release); }
+    void await(int s) const {
+        while (step.load(std::memory_order_acquire) < s) {
+            std::this_thread::yield();
+        }
+    }
+};
+
+Task waitBaud(configly::ChangeStream<RaceCfg>& stream, uint32_t from, uint32_t& got) {
+    got = co_await stream.changed(&RaceConfig::baud, from);
+}
+
+TEST(ConfiglyCoroTest, WakeOnOlderSnapshotLosesNoWaiter) {
+    RaceCfg config;
+    config.setDefault({0, 9600, 0, 0});
+    RaceSteps steps;
+
+    // writer A stops before the stream's wake until B has published, and B
+    // stops before its own wake until A's is over: A's wake then runs on a
+    // snapshot older than version()
+    config.onChange(&RaceConfig::pre, +[](const int& pre, void* s) {
+        auto* steps = static_cast<RaceSteps*>(s);
+        if (pre == 1) {
+            steps->reach(1);
+            steps->await(2);
+        } else {
+            steps->reach(2);
+            steps->await(3);
+        }
+    }, &steps);
+    ManualLoop loop;
+    configly::ChangeStream stream(config, &ManualLoop::post, &loop, &RaceConfig::baud, &RaceConfig::parity);
+    config.onChange(&RaceConfig::post, +[](const int&, void* s) { static_cast<RaceSteps*>(s)->reach(3); }, &steps);
+
+    uint32_t got = 0;
+    Task task = waitBaud(stream, 9600, got);
+    ASSERT_EQ(stream.waiting(), 1u);
+
+    std::thread a([&] { config.modify([](RaceConfig& c) { c.pre = 1; c.parity = 1; c.post = 1; }); });
+    steps.await(1);
+    std::thread b([&] { config.modify([](RaceConfig& c) { c.pre = 2; c.baud = 19200; }); });
+    a.join();
+    b.join();
+
+    ASSERT_EQ(stream.waiting(), 0u);
+    ASSERT_EQ(loop.run(), 1u);
+    ASSERT_EQ(got, 19200u);
+    ASSERT_TRUE(task.handle.done());
+    task.handle.destroy();
+}
@@ -1,9 +1,25 @@
 #include <gtest/gtest.h>
 #include <configly/configly.hpp>
+#include <configly/journal.hpp>
+#include <configly/partitioned.hpp>
+#include <configly/paged.hpp>
+#include <configly/serialize.hpp>
+#include <configly/loader.hpp>
+#include <configly/delta.hpp>
+#include <string>
 #include <thread>
 #include <vector>
 #include <atomic>
 #include <chrono>
+#include <cstddef>
+#include <memory>
+#if defined(__linux__)
+#include <configly/mmap_store.hpp>
+#include <cstdio>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 
 // --- Struttura di test ---
 struct TestConfig {
@@ -53,6 +69,14 @@ TEST_F(ConfiglyTest, GetAndSet) {
     ASSERT_EQ(config.get(&TestConfig::a), 99);
 }
 
+TEST_F(ConfiglyTest, GetMultipleFields) {
+    config.set(&TestConfig::b, 42);
+    auto [a, b, c] = config.get(&TestConfig::a, &TestConfig::b, &TestConfig::c);
+    ASSERT_EQ(a, defaultConfig.a);
+    ASSERT_EQ(b, 42);
+    ASSERT_EQ(c, defaultConfig.c);
+}
+
 TEST_F(ConfiglyTest, RestoreDefaults) {
     config.set(&TestConfig::a, 123);
     config.set(&TestConfig::b, 456);
@@ -73,6 +97,540 @@ TEST_F(ConfiglyTest, CallbackOnSet) {
     ASSERT_EQ(callback_value.load(), 777);
 }
 
+TEST_F(ConfiglyTest, CompileTimeMembers) {
+    static_assert(detail::count_fields<TestConfig>() == 3);
+    static_assert(detail::field_index<TestConfig, &TestConfig::c>() == 2);
+    static_assert(detail::member_offset<TestConfig, &TestConfig::b>() == offsetof(TestConfig, b));
+    static_assert(detail::member_offset<TestConfig, &TestConfig::c>() == offsetof(TestConfig, c));
+
+    config.onChange<&TestConfig::b>(&testCallback);
+    config.set<&TestConfig::b>(31);
+    ASSERT_EQ(config.get<&TestConfig::b>(), 31);
+    ASSERT_EQ(callback_value.load(), 31);
+
+    config.restoreDefault<&TestConfig::b>();
+    ASSERT_EQ(config.get<&TestConfig::b>(), defaultConfig.b);
+    ASSERT_EQ(callback_value.load(), defaultConfig.b);
+}
+
+TEST_F(ConfiglyTest, ReadGuardView) {
+    auto view = config.view();
+    ASSERT_EQ(view->a, defaultConfig.a);
+    ASSERT_TRUE(view.valid());
+
+    // the first write goes to the other buffer of the ring, the second reuses ours
+    config.set(&TestConfig::a, 1);
+    ASSERT_TRUE(view.valid());
+    config.set(&TestConfig::a, 2);
+    ASSERT_FALSE(view.valid());
+
+    view.retry();
+    ASSERT_EQ(view->a, 2u);
+    ASSERT_TRUE(view.valid());
+}
+
+struct ModifyConfig {
+    int x;
+    int y;
+    int z;
+};
+
+void countCallback(const int& /*newValue*/, void* userData) {
+    ++*static_cast<int*>(userData);
+}
+
+TEST(ConfiglyModifyTest, SinglePublishAndChangedFieldsOnly) {
+    auto& config = Configly<ModifyConfig>::instance();
+    config.setDefault({1, 2, 3});
+
+    int xCalls = 0, yCalls = 0, zCalls = 0;
+    config.onChange(&ModifyConfig::x, &countCallback, &xCalls)
+          .onChange(&ModifyConfig::y, &countCallback, &yCalls)
+          .onChange(&ModifyConfig::z, &countCallback, &zCalls);
+
+    auto view = config.view();
+    config.modify([](ModifyConfig& c) {
+        c.x = 10;
+        c.y = 2;    // same as before
+        c.z = 30;
+    });
+    // one publish only: with two buffers the previous snapshot is still intact
+    ASSERT_TRUE(view.valid());
+
+    ModifyConfig current;
+    config.getAll(current);
+    ASSERT_EQ(current.x, 10);
+    ASSERT_EQ(current.y, 2);
+    ASSERT_EQ(current.z, 30);
+    ASSERT_EQ(xCalls, 1);
+    ASSERT_EQ(yCalls, 0);
+    ASSERT_EQ(zCalls, 1);
+}
+
+struct DeferredConfig {
+    int x;
+    int y;
+};
+
+TEST(ConfiglyDeferredTest, CoalescesUntilDispatch) {
+    auto& config = Configly<DeferredConfig>::instance();
+    config.setDefault({0, 0});
+    config.setDispatchMode(configly::DispatchMode::Deferred);
+
+    callback_value = 0;
+    config.onChange(&DeferredConfig::x, &testCallback);
+
+    config.set(&DeferredConfig::x, 1);
+    config.set(&DeferredConfig::x, 2);
+    config.update({3, 0});
+    ASSERT_EQ(callback_value.load(), 0);
+
+    // three changes, one callback, latest value
+    ASSERT_EQ(config.dispatchPending(), 1u);
+    ASSERT_EQ(callback_value.load(), 3);
+    ASSERT_EQ(config.dispatchPending(), 0u);
+}
+
+// --- Test Suite per le sottoscrizioni multiple ---
+void countGroupCallback(const ModifyConfig& /*config*/, void* userData) {
+    ++*static_cast<int*>(userData);
+}
+
+TEST(ConfiglySubscribersTest, SeveralPerFieldAndGroups) {
+    configly::Owned<Configly<ModifyConfig, 8>> config;
+    config.setDefault({0, 0, 0});
+
+    int first = 0, second = 0, group = 0, zGroup = 0;
+    config.onChange(&ModifyConfig::x, &countCallback, &first)
+          .onChange(&ModifyConfig::x, &countCallback, &second)
+          .onAnyChange(&countGroupCallback, &group, &ModifyConfig::x, &ModifyConfig::y);
+    config.onAnyChange<&ModifyConfig::z>(
+        +[](const ModifyConfig& c, void* n) { *static_cast<int*>(n) = c.z; }, &zGroup);
+
+    config.set(&ModifyConfig::x, 1);
+    ASSERT_EQ(first, 1);
+    ASSERT_EQ(second, 1);
+    ASSERT_EQ(group, 1);
+
+    // two fields of the group in one publish: the group runs once
+    config.modify([](ModifyConfig& c) { c.x = 2; c.y = 2; c.z = 5; });
+    ASSERT_EQ(first, 2);
+    ASSERT_EQ(group, 2);
+    ASSERT_EQ(zGroup, 5);
+
+    config.set(&ModifyConfig::z, 6);
+    ASSERT_EQ(group, 2);
+    ASSERT_EQ(zGroup, 6);
+
+    // per-member removal keeps the group
+    config.removeCallback(&ModifyConfig::x);
+    config.set(&ModifyConfig::x, 3);
+    ASSERT_EQ(first, 2);
+    ASSERT_EQ(second, 2);
+    ASSERT_EQ(group, 3);
+
+    config.removeAnyChange(&countGroupCallback);
+    config.set<&ModifyConfig::y>(4);
+    ASSERT_EQ(group, 3);
+
+    // released slots are reused
+    for (int i = 0; i < 7; ++i) {
+        config.onChange(&ModifyConfig::y, &countCallback, &second);
+    }
+    config.set(&ModifyConfig::y, 5);
+    ASSERT_EQ(second, 9);
+}
+
+TEST(ConfiglySubscribersTest, DeferredRunsEachSubscriberOnce) {
+    configly::Owned<Configly<ModifyConfig>> config;
+    config.setDefault({0, 0, 0});
+    config.setDispatchMode(configly::DispatchMode::Deferred);
+
+    int xCalls = 0, group = 0;
+    config.onChange(&ModifyConfig::x, &countCallback, &xCalls)
+          .onAnyChange(&countGroupCallback, &group, &ModifyConfig::x, &ModifyConfig::z);
+
+    config.set(&ModifyConfig::x, 1);
+    config.set(&ModifyConfig::z, 1);
+    config.set(&ModifyConfig::y, 1);
+    ASSERT_EQ(config.dispatchPending(), 2u);
+    ASSERT_EQ(xCalls, 1);
+    ASSERT_EQ(group, 1);
+}
+
+// --- Test Suite per la history ---
+TEST(ConfiglyHistoryTest, DiffSinceAndRollback) {
+    configly::Owned<Configly<ModifyConfig, 3, 4>> config;
+    config.setDefault({0, 0, 0});
+    int xCalls = 0;
+    config.onChange(&ModifyConfig::x, &countCallback, &xCalls);
+
+    const uint64_t v0 = config.version();
+    config.set(&ModifyConfig::x, 1);
+    const uint64_t v1 = config.version();
+    config.set(&ModifyConfig::y, 2);
+    const uint64_t v2 = config.version();
+
+    ASSERT_EQ(config.diffSince(v2), 0u);
+    ASSERT_EQ(config.diffSince(v1), 0b010u);
+    ASSERT_EQ(config.diffSince(v0), 0b011u);
+    ASSERT_EQ(config.diffSince(v2 + 1), ~uint64_t{0});
+    ASSERT_EQ(config.diffSince(0), ~uint64_t{0});  // never a published version
+
+    ASSERT_TRUE(config.rollback(v0));
+    ASSERT_EQ(config.version(), v2 + 1);
+    ASSERT_EQ(config.get(&ModifyConfig::x), 0);
+    ASSERT_EQ(config.get(&ModifyConfig::y), 0);
+    ASSERT_EQ(xCalls, 2);
+    ASSERT_EQ(config.diffSince(v2), 0b011u);
+    ASSERT_TRUE(config.rollback(v2));
+    ASSERT_EQ(config.get(&ModifyConfig::y), 2);
+
+    // the next buffer in the ring now holds v1, the oldest snapshot, and
+    // after one more write v2; refused and no-op edits must leave it in the
+    // history
+    const uint64_t v3 = v2 + 1;
+    config.set(&ModifyConfig::z, 5);
+    const uint64_t v5 = config.version();
+    ASSERT_FALSE(config.tryModify([](ModifyConfig& c) { c.z = 9; return false; }));
+    config.modify([](ModifyConfig&) {});
+    config.setCoalescing(std::chrono::hours(1));
+    config.set(&ModifyConfig::z, 5);  // flushed at once, changing nothing
+    config.setCoalescing(std::chrono::microseconds(0));
+    ASSERT_EQ(config.version(), v5);
+    ASSERT_EQ(config.diffSince(v2), 0b100u);
+    ASSERT_EQ(config.diffSince(v3), 0b111u);
+    ASSERT_EQ(config.diffSince(v5), 0u);
+
+    for (int i = 0; i < 3; ++i) {
+        config.set(&ModifyConfig::z, 10 + i);
+    }
+    ASSERT_EQ(config.diffSince(v0), ~uint64_t{0});
+    ASSERT_FALSE(config.rollback(v0));
+    ASSERT_EQ(config.get(&ModifyConfig::z), 12);
+}
+
+TEST(ConfiglyHistoryTest, RollbackKeepsNewerSnapshots) {
+    configly::Owned<Configly<ModifyConfig, 3, 4>> config;
+    config.setDefault({0, 0, 0});
+    config.set(&ModifyConfig::x, 1);
+    const uint64_t v1 = config.version();
+    config.set(&ModifyConfig::y, 2);
+    const uint64_t v2 = config.version();
+
+    // the restored bytes are published like a write, so the pre-rollback head
+    // is still the newest snapshot left and survives the next write
+    ASSERT_TRUE(config.rollback(v1));
+    const uint64_t v3 = config.version();
+    ASSERT_EQ(config.get(&ModifyConfig::y), 0);
+    config.set(&ModifyConfig::z, 3);
+    ASSERT_EQ(config.diffSince(v2), 0b110u);
+    ASSERT_EQ(config.diffSince(v1), 0b100u);
+
+    // rolling back to the current bytes publishes nothing
+    const uint64_t head = config.version();
+    config.set(&ModifyConfig::z, 0);
+    ASSERT_TRUE(config.rollback(v3));
+    ASSERT_EQ(config.version(), head + 1);
+}
+
+struct BigEditConfig {
+    int x;
+    char blob[1024];
+};
+static_assert(sizeof(BigEditConfig) > CONFIGLY_STACK_EDIT_MAX);
+
+TEST(ConfiglyHistoryTest, BigConfigsEditInTheOpenedBuffer) {
+    configly::Owned<Configly<BigEditConfig, 2, 3>> config;
+    config.setDefault({});
+    config.set(&BigEditConfig::x, 1);
+    const uint64_t v1 = config.version();
+    auto view = config.view();
+
+    ASSERT_FALSE(config.tryModify([](BigEditConfig& c) { c.x = 9; return false; }));
+    config.modify([](BigEditConfig& c) { c.blob[3] = 0; });
+    ASSERT_EQ(config.version(), v1);
+    ASSERT_TRUE(view.valid());  // the active buffer is never the one edited
+    ASSERT_EQ(config.get(&BigEditConfig::x), 1);
+
+    config.modify([](BigEditConfig& c) { c.blob[3] = 'z'; });
+    ASSERT_EQ(config.version(), v1 + 1);
+    ASSERT_EQ(config.diffSince(v1), 0b10u);
+}
+
+// --- Test Suite per la replica a delta ---
+TEST(ConfiglyDeltaTest, ReplicatesOnlyChanges) {
+    using Cfg = Configly<ModifyConfig, 3, 4>;
+    configly::Owned<Cfg> source;
+    configly::Owned<Cfg> replica;
+    source.setDefault({1, 2, 3});
+    replica.setDefault({0, 0, 0});
+    int yCalls = 0;
+    replica.onChange(&ModifyConfig::y, &countCallback, &yCalls);
+
+    unsigned char full[configly::maxDeltaSize<ModifyConfig>()];
+    const size_t fullSize = configly::encodeDelta(source, 0, full, sizeof(full));
+    ASSERT_GT(fullSize, 0u);
+
+    configly::DeltaSync synced;
+    ASSERT_EQ(configly::applyDelta(replica, full, fullSize, synced), configly::DeltaResult::Applied);
+    ASSERT_EQ(synced.version, source.version());
+    ASSERT_EQ(replica.get(&ModifyConfig::z), 3);
+    ASSERT_EQ(yCalls, 1);
+
+    // one changed int: header + one (offset, size) record + 4 bytes + crc
+    const uint64_t v1 = source.version();
+    source.set(&ModifyConfig::y, 20);
+    unsigned char d1[configly::maxDeltaSize<ModifyConfig>()];
+    const size_t d1Size = configly::encodeDelta(source, v1, d1, sizeof(d1));
+    ASSERT_EQ(d1Size, sizeof(configly::DeltaHeader) + 8 + sizeof(int) + 4);
+
+    const uint64_t v2 = source.version();
+    source.modify([](ModifyConfig& c) { c.x = 10; c.z = 30; });
+    unsigned char d2[configly::maxDeltaSize<ModifyConfig>()];
+    const size_t d2Size = configly::encodeDelta(source, v2, d2, sizeof(d2));
+    ASSERT_FALSE(configly::encodeDelta(source, v2, d2, 20));
+
+    // out of order: d2 needs d1 first
+    const uint64_t replicaVersion = replica.version();
+    ASSERT_EQ(configly::applyDelta(replica, d2, d2Size, synced), configly::DeltaResult::Gap);
+    ASSERT_EQ(configly::applyDelta(replica, d1, d1Size, synced), configly::DeltaResult::Applied);
+    ASSERT_EQ(replica.version(), replicaVersion + 1);
+    ASSERT_EQ(yCalls, 2);
+    ASSERT_EQ(configly::applyDelta(replica, d1, d1Size, synced), configly::DeltaResult::Duplicate);
+
+    d2[sizeof(configly::DeltaHeader) + 9] ^= 1;
+    ASSERT_EQ(configly::applyDelta(replica, d2, d2Size, synced), configly::DeltaResult::Invalid);
+    ASSERT_EQ(configly::applyDelta(replica, d2, d2Size - 1, synced), configly::DeltaResult::Invalid);
+    d2[sizeof(configly::DeltaHeader) + 9] ^= 1;
+    ASSERT_EQ(configly::applyDelta(replica, d2, d2Size, synced), configly::DeltaResult::Applied);
+    ASSERT_EQ(configly::applyDelta(replica, d1, d1Size, synced), configly::DeltaResult::Stale);
+
+    ModifyConfig a{}, b{};
+    source.getAll(a);
+    replica.getAll(b);
+    ASSERT_EQ(std::memcmp(&a, &b, sizeof(a)), 0);
+
+    // a version that left the ring degrades to a full patch
+    for (int i = 0; i < 4; ++i) {
+        source.set(&ModifyConfig::x, 100 + i);
+    }
+    const size_t lateSize = configly::encodeDelta(source, v1, full, sizeof(full));
+    ASSERT_EQ(lateSize, configly::maxDeltaSize<ModifyConfig>() - 2 * 8);  // one merged record
+    ASSERT_EQ(configly::applyDelta(replica, full, lateSize, synced), configly::DeltaResult::Applied);
+    ASSERT_EQ(replica.get(&ModifyConfig::x), 103);
+}
+
+TEST(ConfiglyDeltaTest, RestartedSourceResyncsUnderNewEpoch) {
+    using Cfg = Configly<ModifyConfig, 3, 4>;
+    configly::Owned<Cfg> replica;
+    replica.setDefault({0, 0, 0});
+    configly::DeltaSync synced;
+    unsigned char patch[configly::maxDeltaSize<ModifyConfig>()];
+
+    uint64_t before = 0;
+    {
+        configly::Owned<Cfg> source;
+        source.setDefault({1, 2, 3});
+        for (int i = 0; i < 5; ++i) {
+            source.set(&ModifyConfig::x, 10 + i);
+        }
+        const size_t n = configly::encodeDelta(source, 0, patch, sizeof(patch), 7);
+        ASSERT_EQ(configly::applyDelta(replica, patch, n, synced), configly::DeltaResult::Applied);
+        before = source.version();
+    }
+    ASSERT_EQ(synced.epoch, 7u);
+
+    // the restarted source counts from the start again
+    configly::Owned<Cfg> source;
+    source.setDefault({4, 5, 6});
+    const uint64_t v1 = source.version();
+    ASSERT_LT(v1, before);
+    source.set(&ModifyConfig::y, 50);
+    const size_t delta = configly::encodeDelta(source, v1, patch, sizeof(patch), 8);
+    ASSERT_EQ(configly::applyDelta(replica, patch, delta, synced), configly::DeltaResult::Gap);
+
+    const size_t full = configly::encodeDelta(source, 0, patch, sizeof(patch), 8);
+    ASSERT_EQ(configly::applyDelta(replica, patch, full, synced), configly::DeltaResult::Applied);
+    ASSERT_EQ(synced.version, source.version());
+    ASSERT_EQ(synced.epoch, 8u);
+    ASSERT_EQ(replica.get(&ModifyConfig::y), 50);
+
+    const uint64_t v2 = source.version();
+    source.set(&ModifyConfig::z, 60);
+    const size_t next = configly::encodeDelta(source, v2, patch, sizeof(patch), 8);
+    ASSERT_EQ(configly::applyDelta(replica, patch, next, synced), configly::DeltaResult::Applied);
+    ASSERT_EQ(replica.get(&ModifyConfig::z), 60);
+}
+
+// --- Test Suite per gli update senza modifiche ---
+TEST(ConfiglyNoOpTest, UnchangedWritesDoNotPublish) {
+    configly::Owned<Configly<ModifyConfig, 3, 2, configly::AtomicStats>> config;
+    config.setDefault({1, 2, 3});
+    int xCalls = 0;
+    config.onChange(&ModifyConfig::x, &countCallback, &xCalls);
+
+    const uint64_t v = config.version();
+    auto view = config.view();
+    config.update({1, 2, 3});
+    config.set(&ModifyConfig::y, 2);
+    config.set<&ModifyConfig::z>(3);
+    config.modify([](ModifyConfig& c) { c.x = 1; });
+    config.restoreDefaults();
+    ASSERT_EQ(config.version(), v);
+    ASSERT_TRUE(view.valid());
+    ASSERT_EQ(config.stats().skippedPublishes, 5u);
+
+    config.update({4, 2, 3});
+    ASSERT_EQ(config.version(), v + 1);
+    ASSERT_EQ(xCalls, 1);
+    ASSERT_EQ(config.stats().skippedPublishes, 5u);
+}
+
+// --- Test Suite per lo schema ---
+enum class LinkParity : uint8_t { None, Even, Odd, Mark };
+
+struct LinkConfig {
+    uint32_t baud;
+    LinkParity parity;
+    int16_t gain;
+    int retries;   // senza regole
+};
+
+CONFIGLY_SCHEMA(LinkConfig,
+                configly::range<&LinkConfig::baud>(1200, 921600),
+                configly::one_of<&LinkConfig::parity>(LinkParity::None, LinkParity::Even, LinkParity::Odd),
+                configly::step<&LinkConfig::gain>(-60, 60, 6));
+CONFIGLY_REFLECT(LinkConfig, baud, parity, gain, retries);
+
+static_assert(configly::accepts<LinkConfig, &LinkConfig::baud>(115200));
+static_assert(!configly::accepts<LinkConfig, &LinkConfig::baud>(300));
+static_assert(!configly::accepts<LinkConfig, &LinkConfig::parity>(LinkParity::Mark));
+static_assert(configly::accepts<LinkConfig, &LinkConfig::gain>(-54));
+static_assert(!configly::accepts<LinkConfig, &LinkConfig::gain>(5));
+static_assert(!configly::accepts<LinkConfig, &LinkConfig::gain>(-66));
+static_assert(configly::accepts<LinkConfig, &LinkConfig::retries>(-1));
+// a rule built without step() never divides by a zero step
+static_assert(configly::step_rule<&LinkConfig::gain, int16_t>{-6, 6, 0}.accepts(5));
+static_assert(!configly::step_rule<&LinkConfig::gain, int16_t>{-6, 6, 0}.accepts(7));
+
+TEST(ConfiglySchemaTest, RejectedWritesNeverPublish) {
+    configly::Owned<Configly<LinkConfig, 4, 2, configly::AtomicStats>> config;
+    config.setDefault({9600, LinkParity::None, 0, 3});
+    int baudCalls = 0;
+    config.onChange(&LinkConfig::baud, +[](const uint32_t&, void* n) { ++*static_cast<int*>(n); }, &baudCalls);
+
+    const uint64_t v = config.version();
+    auto view = config.view();
+    ASSERT_FALSE(config.set<&LinkConfig::baud>(921601));
+    ASSERT_FALSE(config.set(&LinkConfig::gain, int16_t{7}));
+    ASSERT_FALSE(config.update({115200, LinkParity::Mark, 0, 3}));
+    ASSERT_FALSE(config.tryModify([](LinkConfig& c) { c.gain = 61; return true; }));
+    ASSERT_EQ(config.version(), v);
+    ASSERT_TRUE(view.valid());
+    ASSERT_EQ(baudCalls, 0);
+    ASSERT_EQ(config.stats().rejectedWrites, 4u);
+
+    ASSERT_TRUE(config.set<&LinkConfig::baud>(115200));
+    ASSERT_TRUE(config.set(&LinkConfig::gain, int16_t{-60}));
+    ASSERT_TRUE(config.set<&LinkConfig::retries>(-1));
+    ASSERT_EQ(config.get(&LinkConfig::baud), 115200u);
+    ASSERT_EQ(config.get(&LinkConfig::gain), -60);
+    ASSERT_EQ(baudCalls, 1);
+
+    config.setCoalescing(std::chrono::hours(1));
+    ASSERT_FALSE(config.set<&LinkConfig::parity>(LinkParity::Mark));
+    ASSERT_TRUE(config.set<&LinkConfig::parity>(LinkParity::Odd));
+    config.flush();
+    ASSERT_EQ(config.get(&LinkConfig::parity), LinkParity::Odd);
+    ASSERT_EQ(config.stats().rejectedWrites, 5u);
+}
+
+TEST(ConfiglySchemaTest, LoaderReportsRejection) {
+    configly::Owned<Configly<LinkConfig>> config;
+    config.setDefault({9600, LinkParity::None, 0, 3});
+    const uint64_t v = config.version();
+
+    configly::ParseError error;
+    ASSERT_FALSE(configly::load_json(config, R"({"baud": 100})", configly::LoadBase::Current, &error));
+    ASSERT_STREQ(error.message, "value rejected by schema");
+    ASSERT_EQ(config.version(), v);
+    ASSERT_TRUE(configly::load_json(config, R"({"baud": 19200, "gain": 12})", configly::LoadBase::Current));
+    ASSERT_EQ(config.get(&LinkConfig::gain), 12);
+}
+
+TEST(ConfiglySchemaTest, RejectedLoadKeepsDirtyFields) {
+    configly::Owned<Configly<LinkConfig>> config;
+    config.setDefault({9600, LinkParity::None, 0, 3});
+    config.setSaveFunction(+[](const LinkConfig&) { return true; });
+    config.setLoadFunction(+[](LinkConfig& c) {
+        c = {9600, LinkParity::Mark, 0, 3};
+        return true;
+    });
+    ASSERT_TRUE(config.set<&LinkConfig::retries>(5));
+    const uint64_t v = config.version();
+
+    ASSERT_FALSE(config.load());
+    ASSERT_EQ(config.version(), v);
+    ASSERT_EQ(config.dirtyFields(), 0b1000u);
+    ASSERT_EQ(config.get(&LinkConfig::retries), 5);
+
+    config.setLoadFunction(+[](LinkConfig& c) {
+        c = {19200, LinkParity::Odd, 0, 3};
+        return true;
+    });
+    ASSERT_TRUE(config.load());
+    ASSERT_EQ(config.dirtyFields(), 0u);
+    ASSERT_EQ(config.get(&LinkConfig::baud), 19200u);
+}
+
+TEST(ConfiglyDiffTest, FirstDifference) {
+    unsigned char a[100] = {};
+    unsigned char b[100] = {};
+    ASSERT_EQ(detail::first_difference(a, b, 0, sizeof(a)), sizeof(a));
+    for (size_t i = 0; i < sizeof(a); ++i) {
+        b[i] = 1;
+        ASSERT_EQ(detail::first_difference(a, b, 0, sizeof(a)), i);
+        ASSERT_EQ(detail::first_difference(a, b, i, sizeof(a)), i);
+        ASSERT_EQ(detail::first_difference(a, b, i + 1, sizeof(a)), sizeof(a));
+        b[i] = 0;
+    }
+}
+
+struct WideConfig {
+    uint8_t  flag;
+    uint64_t counters[6];
+    uint16_t port;
+    char     name[21];
+    int32_t  gain;
+};
+
+TEST(ConfiglyDiffTest, UpdateFiresOnlyChangedFields) {
+    auto& config = Configly<WideConfig>::instance();
+    config.setDefault({});
+
+    int flagCalls = 0, portCalls = 0, gainCalls = 0;
+    config.onChange(&WideConfig::gain, +[](const int32_t&, void* n) { ++*static_cast<int*>(n); }, &gainCalls)
+          .onChange(&WideConfig::flag, +[](const uint8_t&, void* n) { ++*static_cast<int*>(n); }, &flagCalls)
+          .onChange(&WideConfig::port, +[](const uint16_t&, void* n) { ++*static_cast<int*>(n); }, &portCalls);
+
+    WideConfig next{};
+    next.counters[3] = 7;   // no callback on this one
+    next.name[20] = 'x';
+    config.update(next);
+    ASSERT_EQ(flagCalls + portCalls + gainCalls, 0);
+
+    next.port = 8080;
+    next.gain = -1;
+    config.update(next);
+    ASSERT_EQ(flagCalls, 0);
+    ASSERT_EQ(portCalls, 1);
+    ASSERT_EQ(gainCalls, 1);
+
+    config.update(next);
+    ASSERT_EQ(portCalls, 1);
+}
+
 // --- Test Suite per la Concorrenza ---
 
 struct ConcurrencyConfig {
@@ -126,6 +684,1109 @@ TEST(ConfiglyConcurrencyTest, NoTornReads) {
     ASSERT_EQ(torn_reads_count.load(), 0);
 }
 
+TEST(ConfiglyConcurrencyTest, RingBuffersNoTornReads) {
+    struct RingConfig {
+        uint64_t val1;
+        uint64_t val2;
+    };
+    auto& config = Configly<RingConfig, 2, 4>::instance();
+    config.setDefault({0, 0});
+
+    std::atomic<bool> stop_signal = false;
+    std::atomic<int> torn_reads_count = 0;
+
+    std::thread writer_thread([&]() {
+        uint64_t i = 1;
+        while (!stop_signal.load()) {
+            config.update({i, i});
+            config.set(&RingConfig::val1, i + 1);
+            config.set<&RingConfig::val2>(i + 1);
+            i += 2;
+        }
+    });
+
+    std::vector<std::thread> reader_threads;
+    for (int i = 0; i < 2; ++i) {
+        reader_threads.emplace_back([&]() {
+            while (!stop_signal.load()) {
+                RingConfig current;
+                config.getAll(current);
+                // val2 is written last, so it may only lag val1 by the pending set()
+                if (current.val2 != current.val1 && current.val2 + 1 != current.val1) {
+                    torn_reads_count++;
+                }
+            }
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    stop_signal.store(true);
+
+    writer_thread.join();
+    for (auto& t : reader_threads) {
+        t.join();
+    }
+
+    ASSERT_EQ(torn_reads_count.load(), 0);
+}
+TEST(ConfiglyWaitTest, WaitForChange) {
+    struct WaitConfig {
+        int x;
+    };
+    auto& config = Configly<WaitConfig>::instance();
+    config.setDefault({0});
+
+    const uint64_t before = config.version();
+    ASSERT_EQ(config.waitForChange(before, std::chrono::milliseconds(5)), before);
+
+    std::atomic<uint64_t> seen = 0;
+    std::thread waiter([&]() {
+        seen = config.waitForChange(before);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    config.set(&WaitConfig::x, 1);
+    waiter.join();
+
+    ASSERT_EQ(seen.load(), before + 1);
+    ASSERT_EQ(config.version(), before + 1);
+
+    // a timed wait is woken by the publish, not by its deadline
+    const auto start = std::chrono::steady_clock::now();
+    std::thread timed([&]() {
+        seen = config.waitForChange(before + 1, std::chrono::seconds(30));
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    config.set(&WaitConfig::x, 2);
+    timed.join();
+    ASSERT_EQ(seen.load(), before + 2);
+    ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(10));
+}
+TEST(ConfiglyStatsTest, CountsWhenEnabled) {
+    struct StatsConfig {
+        int x;
+        int y;
+    };
+    auto& config = Configly<StatsConfig, 2, 2, configly::AtomicStats>::instance();
+    config.setDefault({0, 0});
+
+    int xCalls = 0;
+    config.onChange(&StatsConfig::x, &countCallback, &xCalls);
+    config.set(&StatsConfig::x, 1);
+    config.set<&StatsConfig::y>(1);
+    config.update({2, 2});
+    config.modify([](StatsConfig& c) { c.y = 3; });
+
+    const configly::StatsSnapshot s = config.stats();
+    ASSERT_EQ(s.sets, 2u);
+    ASSERT_EQ(s.updates, 2u);
+    ASSERT_EQ(s.callbacks, 2u);
+    ASSERT_EQ(xCalls, 2);
+
+    // the default policy keeps nothing
+    ASSERT_EQ(Configly<StatsConfig>::instance().stats().sets, 0u);
+    static_assert(!configly::NoStats::kEnabled);
+}
+// --- Test Suite per istanze multiple / stato condiviso ---
+
+struct SharedConfig {
+    uint32_t counter;
+    int32_t level;
+};
+
+TEST(ConfiglyInstanceTest, OwnedInstancesAreIndependent) {
+    configly::Owned<Configly<SharedConfig>> first;
+    configly::Owned<Configly<SharedConfig>> second;
+    first.setDefault({1, 1});
+    second.setDefault({2, 2});
+
+    first.set(&SharedConfig::counter, 10u);
+    ASSERT_EQ(first.get(&SharedConfig::counter), 10u);
+    ASSERT_EQ(second.get(&SharedConfig::counter), 2u);
+    ASSERT_NE(&Configly<SharedConfig>::instance(), static_cast<Configly<SharedConfig>*>(&first));
+}
+
+TEST(ConfiglyInstanceTest, AttachedInstancesShareStateNotCallbacks) {
+    static_assert(std::is_standard_layout<Configly<SharedConfig>::State>::value);
+
+    Configly<SharedConfig>::State state;
+    Configly<SharedConfig> writer(state);
+    Configly<SharedConfig> reader(state);
+    writer.setDefault({0, 0});
+
+    int writerCalls = 0;
+    writer.onChange(&SharedConfig::level, +[](const int32_t&, void* n) { ++*static_cast<int*>(n); }, &writerCalls);
+
+    reader.set(&SharedConfig::level, -5);
+    ASSERT_EQ(writer.get(&SharedConfig::level), -5);
+    ASSERT_EQ(writerCalls, 0);
+
+    writer.set(&SharedConfig::level, 7);
+    ASSERT_EQ(reader.get(&SharedConfig::level), 7);
+    ASSERT_EQ(writerCalls, 1);
+    ASSERT_EQ(reader.version(), writer.version());
+}
+
+#if defined(__linux__)
+TEST(ConfiglyInstanceTest, SharedMemoryAcrossProcesses) {
+    using Cfg = Configly<SharedConfig>;
+    static_assert(Cfg::State::kProcessShareable);
+
+    void* mem = mmap(nullptr, sizeof(Cfg::State), PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    ASSERT_NE(mem, MAP_FAILED);
+    auto* state = new (mem) Cfg::State();
+    Cfg parent(*state);
+    parent.setDefault({0, 0});
+
+    const pid_t child = fork();
+    ASSERT_GE(child, 0);
+    if (child == 0) {
+        Cfg writer(*state);
+        for (uint32_t i = 1; i <= 1000; ++i) {
+            writer.update({i, -static_cast<int32_t>(i)});
+        }
+        _exit(0);
+    }
+
+    SharedConfig seen{};
+    bool consistent = true;
+    int status = 0;
+    pid_t done = 0;
+    while (done == 0) {
+        done = waitpid(child, &status, WNOHANG);
+        parent.getAll(seen);
+        consistent = consistent && (seen.level == -static_cast<int32_t>(seen.counter));
+    }
+
+    ASSERT_TRUE(consistent);
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+    ASSERT_EQ(seen.counter, 1000u);
+    munmap(mem, sizeof(Cfg::State));
+}
+#endif
+
+#if defined(CONFIGLY_HAS_FUTEX)
+TEST(ConfiglyInstanceTest, WaitForChangeAcrossProcesses) {
+    using Cfg = Configly<SharedConfig>;
+    void* mem = mmap(nullptr, sizeof(Cfg::State), PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    ASSERT_NE(mem, MAP_FAILED);
+    auto* state = new (mem) Cfg::State();
+    Cfg parent(*state);
+    parent.setDefault({0, 0});
+    const uint64_t before = parent.version();
+
+    const pid_t child = fork();
+    ASSERT_GE(child, 0);
+    if (child == 0) {
+        // publish only once the parent is asleep in waitForChange()
+        Cfg writer(*state);
+        while (state->versionSleepers.load() == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        writer.set(&SharedConfig::counter, 42u);
+        _exit(0);
+    }
+
+    alarm(20);  // a lost wake fails the test instead of hanging it
+    const uint64_t seen = parent.waitForChange(before);
+    alarm(0);
+    int status = 0;
+    waitpid(child, &status, 0);
+
+    ASSERT_EQ(seen, before + 1);
+    ASSERT_EQ(parent.get(&SharedConfig::counter), 42u);
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+    munmap(mem, sizeof(Cfg::State));
+}
+#endif
+
+// --- Test Suite per le policy di lock ---
+template<typename Lock>
+void runContendedIncrements() {
+    using Cfg = Configly<ModifyConfig, 3, 2, configly::AtomicStats, Lock>;
+    configly::Owned<Cfg> cfg;
+    cfg.setDefault({0, 0, 0});
+
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 4; ++t) {
+        writers.emplace_back([&cfg]() {
+            for (int i = 0; i < 2000; ++i) {
+                cfg.modify([](ModifyConfig& c) { ++c.x; });
+            }
+        });
+    }
+    for (auto& w : writers) {
+        w.join();
+    }
+    ASSERT_EQ(cfg.get(&ModifyConfig::x), 8000);
+    ASSERT_EQ(cfg.stats().updates, 8000u);
+}
+
+TEST(ConfiglyLockTest, SpinLockSerializesWriters) {
+    runContendedIncrements<configly::SpinLock>();
+}
+
+#if defined(CONFIGLY_HAS_PTHREAD)
+TEST(ConfiglyLockTest, PiMutexSerializesWriters) {
+    runContendedIncrements<configly::PiMutexLock>();
+}
+#endif
+
+TEST(ConfiglyLockTest, NoLockSingleWriter) {
+    using Cfg = Configly<ModifyConfig, 3, 2, configly::NoStats, configly::NoLock>;
+    static_assert(Cfg::State::kProcessShareable);
+    configly::Owned<Cfg> cfg;
+    cfg.setDefault({0, 0, 0});
+    for (int i = 1; i <= 10; ++i) {
+        cfg.set(&ModifyConfig::y, i);
+    }
+    ASSERT_EQ(cfg.get(&ModifyConfig::y), 10);
+}
+
+// --- Test Suite per LocalCache ---
+TEST(ConfiglyLocalCacheTest, RecopiesOnlyAfterPublish) {
+    configly::Owned<Configly<ModifyConfig>> cfg;
+    cfg.setDefault({1, 2, 3});
+
+    Configly<ModifyConfig>::LocalCache cache(cfg);
+    ASSERT_FALSE(cache.stale());
+    ASSERT_EQ(cache.get(&ModifyConfig::y), 2);
+    const uint64_t v = cache.version();
+
+    cfg.set(&ModifyConfig::y, 20);
+    ASSERT_TRUE(cache.stale());
+    ASSERT_EQ(cache->y, 20);
+    ASSERT_FALSE(cache.stale());
+    ASSERT_GT(cache.version(), v);
+
+    const ModifyConfig* copy = &cache.get();
+    ASSERT_EQ(copy, &*cache);  // same private copy, no refresh when nothing changed
+}
+
+// --- Test Suite per le sezioni ---
+struct NetworkSection {
+    uint32_t ip;
+    uint16_t port;
+};
+
+struct MotorSection {
+    int rpm;
+    float torque;
+};
+
+struct LogSection {
+    int level;
+};
+
+struct SectionedConfig {
+    NetworkSection network;
+    MotorSection motor;
+    LogSection logging;
+};
+
+TEST(ConfiglyPartitionedTest, SectionsAreIndependent) {
+    configly::Partitioned<SectionedConfig> cfg;
+    static_assert(decltype(cfg)::kSections == 3);
+    cfg.setDefault({{0x7F000001u, 80}, {0, 0.0f}, {1}});
+
+    auto& motor = cfg.section<&SectionedConfig::motor>();
+    auto& network = cfg.section<&SectionedConfig::network>();
+    int calls = 0;
+    motor.onChange(&MotorSection::rpm, countCallback, &calls);
+
+    const uint64_t networkVersion = network.version();
+    motor.set(&MotorSection::rpm, 1200);
+    ASSERT_EQ(calls, 1);
+    ASSERT_EQ(network.version(), networkVersion);  // network readers untouched
+
+    const MotorSection m = cfg.getSection<&SectionedConfig::motor>();
+    ASSERT_EQ(m.rpm, 1200);
+    ASSERT_EQ(cfg.getSection<&SectionedConfig::network>().port, 80);
+
+    SectionedConfig all{};
+    cfg.getAll(all);
+    ASSERT_EQ(all.motor.rpm, 1200);
+    ASSERT_EQ(all.logging.level, 1);
+
+    all.logging.level = 3;
+    cfg.update(all);
+    ASSERT_EQ(cfg.getSection<&SectionedConfig::logging>().level, 3);
+    ASSERT_EQ(calls, 1);  // motor bytes did not change
+}
+
+// --- Test Suite per la modalita' a pagine ---
+struct PagedWord {
+    uint32_t lo;
+    uint32_t hi;
+};
+
+struct CalibrationTable {
+    uint32_t revision;
+    char header[4088];
+    PagedWord straddle;  // bytes 4092..4099: across the first page boundary
+    float curve[3000];
+    uint64_t stamp;
+    float gain;
+};
+
+TEST(ConfiglyPagedTest, WritesRepublishOnlyTouchedPages) {
+    using Table = configly::Paged<CalibrationTable, 4096, 2, configly::AtomicStats>;
+    static_assert(Table::kPages == 4);
+    auto table = std::make_unique<Table>();
+    CalibrationTable defaults{};
+    defaults.gain = 1.0f;
+    ASSERT_EQ(table->pageVersion(0), 0u);  // nothing published yet
+    table->setDefault(defaults);
+    ASSERT_EQ(table->pageOf(&CalibrationTable::straddle), 0u);
+    ASSERT_EQ(table->pageOf(&CalibrationTable::gain), 3u);
+
+    ASSERT_TRUE(table->set(&CalibrationTable::gain, 2.5f));
+    ASSERT_EQ(table->version(), 2u);
+    ASSERT_EQ(table->pageVersion(3), 2u);
+    ASSERT_EQ(table->pageVersion(0), 1u);  // readers of page 0 never noticed
+    ASSERT_EQ(table->get(&CalibrationTable::gain), 2.5f);
+
+    ASSERT_TRUE(table->set<&CalibrationTable::straddle>(PagedWord{7, 9}));
+    ASSERT_EQ(table->pageVersion(0), 3u);
+    ASSERT_EQ(table->pageVersion(1), 3u);
+    ASSERT_EQ(table->pageVersion(3), 2u);
+    const PagedWord w = table->get<&CalibrationTable::straddle>();
+    ASSERT_EQ(w.lo, 7u);
+    ASSERT_EQ(w.hi, 9u);
+
+    ASSERT_TRUE(table->set(&CalibrationTable::gain, 2.5f));  // same bytes
+    ASSERT_EQ(table->version(), 3u);
+    ASSERT_EQ(table->stats().skippedPublishes, 1u);
+
+    CalibrationTable all{};
+    table->getAll(all);
+    ASSERT_EQ(all.straddle.hi, 9u);
+    ASSERT_EQ(all.gain, 2.5f);
+    all.curve[1500] = 0.5f;  // page 2 only
+    ASSERT_TRUE(table->update(all));
+    ASSERT_EQ(table->pageVersion(2), 4u);
+    ASSERT_EQ(table->pageVersion(1), 3u);
+    ASSERT_EQ(table->pageVersion(3), 2u);
+
+    table->restoreDefaults();
+    ASSERT_EQ(table->get(&CalibrationTable::gain), 1.0f);
+    ASSERT_EQ(table->get(&CalibrationTable::straddle).lo, 0u);
+}
+
+TEST(ConfiglyPagedTest, GetAllSeesEveryPageFromOneWrite) {
+    using Table = configly::Paged<CalibrationTable, 4096>;
+    auto table = std::make_unique<Table>();
+    table->setDefault({});
+
+    std::atomic<bool> stop{false};
+    std::atomic<int> torn{0};
+    std::thread writer([&]() {
+        auto next = std::make_unique<CalibrationTable>();
+        for (uint32_t i = 1; !stop.load(); ++i) {
+            if (i & 1u) {
+                // first and last page in one write
+                next->revision = i;
+                next->stamp = i;
+                table->update(*next);
+            } else {
+                table->set(&CalibrationTable::straddle, PagedWord{i, i});
+            }
+        }
+    });
+    std::thread reader([&]() {
+        auto snapshot = std::make_unique<CalibrationTable>();
+        while (!stop.load()) {
+            table->getAll(*snapshot);
+            const PagedWord w = table->get(&CalibrationTable::straddle);
+            if (snapshot->revision != snapshot->stamp || w.lo != w.hi) {
+                torn++;
+            }
+        }
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    stop.store(true);
+    writer.join();
+    reader.join();
+    ASSERT_EQ(torn.load(), 0);
+}
+
+// --- Test Suite per l'inizializzazione statica ---
+struct BootConfig {
+    uint32_t baud;
+    int16_t gain;
+    uint8_t retries;
+};
+
+inline constexpr BootConfig kBootDefaults{115200, -3, 7};
+using BootCfg = configly::Static<Configly<BootConfig, 2, 4>, kBootDefaults>;
+
+// the state is a constant expression, so BootCfg::instance() is constant-initialized
+[[maybe_unused]] constexpr BootCfg::State kBootState(kBootDefaults);
+
+TEST(ConfiglyStaticTest, StartsAtCompileTimeDefaults) {
+    auto& cfg = BootCfg::instance();
+    ASSERT_EQ(&cfg, &BootCfg::instance());
+    ASSERT_EQ(cfg.version(), 1u);  // as right after setDefault()
+    ASSERT_EQ(cfg.get(&BootConfig::baud), 115200u);
+    ASSERT_EQ(cfg.getDefault().gain, -3);
+
+    BootConfig all{};
+    cfg.getAll(all);
+    ASSERT_EQ(all.retries, 7);
+
+    int calls = 0;
+    cfg.onChange(&BootConfig::baud, +[](const uint32_t&, void* c) { ++*static_cast<int*>(c); }, &calls);
+    cfg.set(&BootConfig::baud, 9600u);
+    ASSERT_EQ(calls, 1);
+    ASSERT_EQ(cfg.version(), 2u);
+    ASSERT_EQ(cfg.diffSince(1), 0b001u);
+
+    ASSERT_TRUE(cfg.rollback(1));  // the defaults are history like any version
+    ASSERT_EQ(cfg.get(&BootConfig::baud), 115200u);
+    ASSERT_EQ(calls, 2);
+}
+
+// --- Test Suite per la serializzazione ---
+enum class Mode : uint8_t { Off, On };
+
+struct SerialMotor {
+    int rpm;
+    float torque;
+};
+
+struct SerialConfig {
+    bool enabled;
+    Mode mode;
+    SerialMotor motor;
+    char name[12];
+    uint16_t ports[3];
+};
+
+CONFIGLY_REFLECT(SerialMotor, rpm, torque);
+CONFIGLY_REFLECT(SerialConfig, enabled, mode, motor, name, ports);
+
+TEST(ConfiglySerializeTest, FieldNames) {
+    constexpr auto names = configly::field_names<SerialConfig>();
+    static_assert(names.size() == 5);
+    static_assert(names[2] == "motor" && names[4] == "ports");
+    static_assert(detail::field_layout<SerialConfig>.size() == 5);
+    ASSERT_EQ(detail::field_layout<SerialConfig>[2].offset, offsetof(SerialConfig, motor));
+}
+
+TEST(ConfiglySerializeTest, JsonAndIni) {
+    const SerialConfig cfg{true, Mode::On, {1200, 1.5f}, "pump \"A\"", {80, 443, 8080}};
+
+    char buf[256];
+    const size_t n = configly::write_json(cfg, buf, sizeof(buf));
+    ASSERT_EQ(std::string(buf, n),
+              R"({"enabled":true,"mode":1,"motor":{"rpm":1200,"torque":1.5},"name":"pump \"A\"","ports":[80,443,8080]})");
+    ASSERT_EQ(configly::write_json(cfg, buf, 4), n);  // reports the full length when truncated
+
+    const size_t m = configly::write_ini(cfg, buf, sizeof(buf));
+    ASSERT_EQ(std::string(buf, m),
+              "enabled=true\nmode=1\nname=\"pump \\\"A\\\"\"\nports=80,443,8080\n[motor]\nrpm=1200\ntorque=1.5\n");
+}
+
+TEST(ConfiglySerializeTest, BinaryRoundTripThroughHooks) {
+    static std::array<unsigned char, configly::binary_size<SerialConfig>()> storage{};
+    static_assert(configly::binary_size<SerialConfig>() ==
+                  16 + 1 + 1 + sizeof(int) + sizeof(float) + 12 + 3 * sizeof(uint16_t));
+
+    configly::Owned<Configly<SerialConfig>> cfg;
+    cfg.setDefault({});
+    cfg.setSaveFunction(+[](const SerialConfig& c) {
+        return configly::write_binary(c, storage.data(), storage.size()) != 0;
+    });
+    cfg.setLoadFunction(+[](SerialConfig& c) {
+        return configly::read_binary(c, storage.data(), storage.size());
+    });
+
+    cfg.set(&SerialConfig::mode, Mode::On);
+    cfg.modify([](SerialConfig& c) { c.motor.rpm = 900; c.ports[2] = 7; });
+    ASSERT_TRUE(cfg.save());
+
+    cfg.restoreDefaults();
+    ASSERT_TRUE(cfg.load());
+    SerialConfig out{};
+    cfg.getAll(out);
+    ASSERT_EQ(out.mode, Mode::On);
+    ASSERT_EQ(out.motor.rpm, 900);
+    ASSERT_EQ(out.ports[2], 7);
+
+    storage[20] ^= 0xFF;  // corrupt the payload
+    SerialConfig untouched{};
+    ASSERT_FALSE(configly::read_binary(untouched, storage.data(), storage.size()));
+    ASSERT_EQ(untouched.motor.rpm, 0);
+}
+
+// --- Test Suite per i contenitori a capacita' fissa ---
+struct TextConfig {
+    int level;
+    configly::fixed_string<32> name;
+    configly::fixed_vector<uint16_t, 8> ports;
+};
+
+CONFIGLY_REFLECT(TextConfig, level, name, ports);
+
+TEST(ConfiglyFixedTest, TracksLengthAndKeepsTailsZero) {
+    static_assert(std::is_trivially_copyable_v<TextConfig>);
+    static_assert(detail::count_fields<TextConfig>() == 3);
+    static_assert(detail::has_trimmed_fields<TextConfig>());
+
+    configly::fixed_string<8> s = "toolongvalue";
+    static_assert(configly::fixed_string<4>("ab").size() == 2);
+    ASSERT_EQ(s.size(), 8u);
+    ASSERT_FALSE(s.assign("abcdefghi"));
+    ASSERT_TRUE(s.assign("ab"));
+    configly::fixed_string<8> t = "ab";
+    ASSERT_TRUE(s == "ab");
+    ASSERT_EQ(std::memcmp(&s, &t, sizeof(s)), 0);  // equal contents, equal bytes
+
+    configly::fixed_vector<int, 4> v{1, 2, 3};
+    v.pop_back();
+    configly::fixed_vector<int, 4> w{1, 2};
+    ASSERT_EQ(std::memcmp(&v, &w, sizeof(v)), 0);
+    ASSERT_FALSE((configly::fixed_vector<int, 2>{1, 2}.push_back(3)));
+}
+
+TEST(ConfiglyFixedTest, ConfiglyCopiesLiveBytes) {
+    configly::Owned<Configly<TextConfig>> config;
+    TextConfig defaults{};
+    defaults.name = "a rather long default name";
+    config.setDefault(defaults);
+
+    std::string seen;
+    config.onChange(&TextConfig::name, +[](const configly::fixed_string<32>& n, void* out) {
+        *static_cast<std::string*>(out) = std::string(n.view());
+    }, &seen);
+
+    config.set(&TextConfig::name, "pump");
+    config.modify([](TextConfig& c) { c.ports.push_back(80); c.ports.push_back(443); });
+    ASSERT_EQ(seen, "pump");
+
+    // the reader copy held the longer name before: its tail must end up zero
+    TextConfig out = defaults;
+    config.getAll(out);
+    TextConfig expected{};
+    expected.name = "pump";
+    expected.ports = {80, 443};
+    ASSERT_EQ(std::memcmp(&out, &expected, sizeof(out)), 0);
+
+    const uint64_t v = config.version();
+    config.update(expected);
+    ASSERT_EQ(config.version(), v);
+
+    char text[128];
+    const size_t n = configly::write_json(out, text, sizeof(text));
+    ASSERT_EQ(std::string(text, n), "{\"level\":0,\"name\":\"pump\",\"ports\":[80,443]}");
+    ASSERT_TRUE(configly::load_json(config, R"({"name": "valve", "ports": [1, 2, 3]})"));
+    ASSERT_TRUE(config.get(&TextConfig::name) == "valve");
+    ASSERT_EQ(config.get(&TextConfig::ports).size(), 3u);
+    ASSERT_TRUE(configly::load_ini(config, "ports = 7\nname = x\n"));
+    ASSERT_EQ(config.get(&TextConfig::ports).size(), 1u);
+    ASSERT_TRUE(config.get(&TextConfig::name) == "x");
+    ASSERT_FALSE(configly::load_json(config, R"({"ports": [1, 2, 3, 4, 5, 6, 7, 8, 9]})"));
+}
+
+// --- Test Suite per il loader ---
+TEST(ConfiglyLoaderTest, JsonSinglePublish) {
+    configly::Owned<Configly<SerialConfig>> cfg;
+    SerialConfig defaults{};
+    defaults.motor.rpm = 100;
+    cfg.setDefault(defaults);
+    int calls = 0;
+    cfg.onChange(&SerialConfig::enabled, +[](const bool&, void* n) { ++*static_cast<int*>(n); }, &calls);
+
+    const uint64_t v = cfg.version();
+    const char* json = R"({
+        "enabled": true, "mode": 1, "future_key": {"x": [1, "two"]},
+        "name": "café \"x\"",
+        "motor": {"torque": -2.5e1},
+        "ports": [1, 70000]
+    })";
+    configly::ParseError err;
+    ASSERT_FALSE(configly::load_json(cfg, json, configly::LoadBase::Defaults, &err));  // out of range
+    ASSERT_EQ(cfg.version(), v);
+    ASSERT_STREQ(err.message, "bad value for field type");
+
+    const std::string fixed = std::string(json).replace(std::string(json).find("70000"), 5, "16");
+    ASSERT_TRUE(configly::load_json(cfg, fixed));
+    ASSERT_EQ(cfg.version(), v + 1);
+    ASSERT_EQ(calls, 1);
+
+    SerialConfig out{};
+    cfg.getAll(out);
+    ASSERT_TRUE(out.enabled);
+    ASSERT_EQ(out.mode, Mode::On);
+    ASSERT_EQ(out.motor.rpm, 100);  // missing key: default
+    ASSERT_FLOAT_EQ(out.motor.torque, -25.0f);
+    ASSERT_STREQ(out.name, "caf\xc3\xa9 \"x\"");
+    ASSERT_EQ(out.ports[1], 16);
+
+    // writer output parses back to the same bytes
+    char text[256];
+    const size_t n = configly::write_json(out, text, sizeof(text));
+    SerialConfig again{};
+    ASSERT_TRUE(configly::parse_json(std::string_view(text, n), again));
+    ASSERT_EQ(std::memcmp(&out, &again, sizeof(out)), 0);
+}
+
+TEST(ConfiglyLoaderTest, IniAndToml) {
+    configly::Owned<Configly<SerialConfig>> cfg;
+    cfg.setDefault({});
+
+    const char* ini =
+        "; comment\n"
+        "enabled = true\n"
+        "name = it's text ; inline\n"
+        "ports = [8, 9]   # toml array\n"
+        "unknown = 3\n"
+        "\n"
+        "[motor]\n"
+        "rpm = 1500\n";
+    ASSERT_TRUE(configly::load_ini(cfg, ini));
+    ASSERT_EQ(cfg.get(&SerialConfig::motor).rpm, 1500);
+    SerialConfig first{};
+    cfg.getAll(first);
+    ASSERT_STREQ(first.name, "it's text");
+
+    const char* toml = "motor.torque = 0.5\nname = \"a # b\" # comment\n";
+    ASSERT_TRUE(configly::load_ini(cfg, toml, configly::LoadBase::Current));
+    SerialConfig out{};
+    cfg.getAll(out);
+    ASSERT_EQ(out.motor.rpm, 1500);  // kept: based on the current config
+    ASSERT_EQ(out.ports[1], 9);
+    ASSERT_FLOAT_EQ(out.motor.torque, 0.5f);
+    ASSERT_STREQ(out.name, "a # b");
+
+    configly::ParseError err;
+    const uint64_t v = cfg.version();
+    ASSERT_FALSE(configly::load_ini(cfg, "enabled = true\n[motor]\nrpm = fast\n",
+                                    configly::LoadBase::Current, &err));
+    ASSERT_EQ(err.offset, 23u);
+    ASSERT_EQ(cfg.version(), v);
+
+    // strings are written quoted, so comment markers survive the round trip
+    std::strcpy(out.name, " a # \"b\"; ");
+    char text[256];
+    const size_t n = configly::write_ini(out, text, sizeof(text));
+    SerialConfig again{};
+    ASSERT_TRUE(configly::parse_ini(std::string_view(text, n), again));
+    ASSERT_EQ(std::memcmp(&out, &again, sizeof(out)), 0);
+}
+
+#if defined(CONFIGLY_HAS_MMAP_LOADER)
+TEST(ConfiglyLoaderTest, LoadsMappedFile) {
+    char path[] = "/tmp/configly_loadXXXXXX";
+    const int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    const std::string json = "  {\"motor\": {\"rpm\": 42}}\n";
+    ASSERT_EQ(write(fd, json.data(), json.size()), static_cast<ssize_t>(json.size()));
+    close(fd);
+
+    configly::Owned<Configly<SerialConfig>> cfg;
+    cfg.setDefault({});
+    ASSERT_TRUE(configly::load_file(cfg, path));
+    ASSERT_EQ(cfg.get(&SerialConfig::motor).rpm, 42);
+    std::remove(path);
+    ASSERT_FALSE(configly::load_file(cfg, path));
+
+    // an empty file, or one of only comments, is not a valid load
+    const uint64_t v = cfg.version();
+    for (const std::string text : {std::string(), std::string("# nothing here\n\n")}) {
+        char empty[] = "/tmp/configly_emptyXXXXXX";
+        const int efd = mkstemp(empty);
+        ASSERT_GE(efd, 0);
+        ASSERT_EQ(write(efd, text.data(), text.size()), static_cast<ssize_t>(text.size()));
+        close(efd);
+        configly::ParseError err;
+        ASSERT_FALSE(configly::load_file(cfg, empty, configly::LoadBase::Defaults, &err));
+        ASSERT_STREQ(err.message, text.empty() ? "empty file" : "neither JSON nor INI");
+        std::remove(empty);
+    }
+    ASSERT_EQ(cfg.version(), v);
+}
+#endif
+
+TEST(ConfiglyLoaderTest, ParsesIntoCallerScratch) {
+    configly::Owned<Configly<SerialConfig>> cfg;
+    cfg.setDefault({});
+    SerialConfig scratch{};
+    ASSERT_TRUE(configly::load_ini(cfg, "[motor]\nrpm = 7\n", scratch));
+    ASSERT_TRUE(configly::load_json(cfg, R"({"ports": [5]})", scratch, configly::LoadBase::Current));
+    ASSERT_EQ(cfg.get(&SerialConfig::motor).rpm, 7);
+    cfg.getAll(scratch);
+    ASSERT_EQ(scratch.ports[0], 5);
+
+    // the publish behind LoadBase::Current: only on top of the version it read
+    const uint64_t v = cfg.version();
+    SerialConfig next{};
+    cfg.getAll(next);
+    next.motor.rpm = 8;
+    cfg.set(&SerialConfig::enabled, true);
+    ASSERT_FALSE(cfg.compareAndUpdate(v, next));
+    ASSERT_EQ(cfg.get(&SerialConfig::motor).rpm, 7);
+    ASSERT_TRUE(cfg.compareAndUpdate(v + 1, next));
+    ASSERT_EQ(cfg.get(&SerialConfig::motor).rpm, 8);
+}
+
+// --- Test Suite per la modalita' coalescing ---
+TEST(ConfiglyCoalesceTest, PublishesOncePerWindow) {
+    using Cfg = Configly<ModifyConfig>;
+    Cfg::State state;
+    Cfg cfg(state);
+    Cfg other(state);
+    cfg.setDefault({0, 0, 0});
+    int calls = 0;
+    cfg.onChange(&ModifyConfig::x, countCallback, &calls);
+    cfg.setCoalescing(std::chrono::hours(1));
+
+    cfg.set(&ModifyConfig::x, 1);  // first write of the window goes out at once
+    ASSERT_EQ(cfg.get(&ModifyConfig::x), 1);
+    ASSERT_EQ(calls, 1);
+
+    const uint64_t v = cfg.version();
+    for (int i = 2; i <= 100; ++i) {
+        cfg.set(&ModifyConfig::x, i);
+    }
+    cfg.modify([](ModifyConfig& c) { c.y = 7; });
+    other.set(&ModifyConfig::z, 3);  // another instance, not coalescing
+    ASSERT_EQ(cfg.get(&ModifyConfig::x), 1);
+    ASSERT_EQ(cfg.version(), v + 1);
+    ASSERT_FALSE(cfg.flushIfDue());
+
+    ASSERT_TRUE(cfg.flush());
+    ASSERT_EQ(calls, 2);
+    ASSERT_EQ(cfg.version(), v + 2);
+    ASSERT_EQ(cfg.get(&ModifyConfig::x), 100);
+    ASSERT_EQ(cfg.get(&ModifyConfig::y), 7);
+    ASSERT_EQ(cfg.get(&ModifyConfig::z), 3);  // untouched fields are not overwritten
+    ASSERT_FALSE(cfg.flush());
+
+    cfg.set(&ModifyConfig::x, 5);
+    cfg.setCoalescing(std::chrono::microseconds(0));  // disabling flushes
+    ASSERT_EQ(cfg.get(&ModifyConfig::x), 5);
+    cfg.set(&ModifyConfig::x, 6);
+    ASSERT_EQ(cfg.get(&ModifyConfig::x), 6);
+}
+
+// --- Test Suite per MappedStore ---
+#if defined(__linux__)
+struct StoredConfig {
+    uint32_t counter;
+    int32_t level;
+    char name[5000];  // spans more than one page
+};
+
+TEST(ConfiglyMappedStoreTest, SaveAndLoadRoundTrip) {
+    char path[] = "/tmp/configly_storeXXXXXX";
+    const int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    close(fd);
+
+    {
+        configly::Owned<Configly<StoredConfig>> cfg;
+        cfg.setDefault({});
+        configly::MappedStore<StoredConfig> store;
+        ASSERT_TRUE(store.open(path));
+        ASSERT_EQ(store.generation(), 0u);
+        store.attach(cfg);
+
+        cfg.set(&StoredConfig::counter, 7u);
+        ASSERT_TRUE(cfg.save());
+        ASSERT_EQ(store.generation(), 1u);
+        ASSERT_TRUE(cfg.save());  // unchanged: no new generation
+        ASSERT_EQ(store.generation(), 1u);
+
+        cfg.set(&StoredConfig::level, -3);
+        ASSERT_TRUE(store.save(cfg));
+        ASSERT_EQ(store.generation(), 2u);
+        ASSERT_TRUE(store.save(cfg));
+        ASSERT_EQ(store.generation(), 2u);
+    }
+
+    configly::Owned<Configly<StoredConfig>> restored;
+    restored.setDefault({});
+    configly::MappedStore<StoredConfig> store;
+    ASSERT_TRUE(store.open(path));
+    store.attach(restored);
+    ASSERT_TRUE(restored.load());
+    ASSERT_EQ(restored.get(&StoredConfig::counter), 7u);
+    ASSERT_EQ(restored.get(&StoredConfig::level), -3);
+    store.close();
+
+    // corrupting the newest image falls back to the previous generation
+    FILE* f = std::fopen(path, "r+b");
+    ASSERT_NE(f, nullptr);
+    const long slotSize = static_cast<long>(2 * sysconf(_SC_PAGESIZE));
+    std::fseek(f, slotSize + static_cast<long>(sizeof(configly::MappedStore<StoredConfig>::Header)) + 4, SEEK_SET);
+    std::fputc(0x55, f);
+    std::fclose(f);
+
+    ASSERT_TRUE(store.open(path));
+    ASSERT_EQ(store.generation(), 1u);
+    ASSERT_TRUE(restored.load());
+    ASSERT_EQ(restored.get(&StoredConfig::level), 0);
+
+    // a different layout version ignores both images
+    ASSERT_TRUE(store.open(path, 2));
+    ASSERT_FALSE(restored.load());
+    store.close();
+    std::remove(path);
+}
+
+TEST(ConfiglyMappedStoreTest, SavesSmallConfigFromSnapshot) {
+    char path[] = "/tmp/configly_storeXXXXXX";
+    const int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    close(fd);
+
+    configly::Owned<Configly<ModifyConfig>> cfg;
+    cfg.setDefault({1, 2, 3});
+    configly::MappedStore<ModifyConfig> store;
+    ASSERT_TRUE(store.open(path));
+    ASSERT_TRUE(store.save(cfg));
+    ASSERT_TRUE(store.save(cfg));
+    ASSERT_EQ(store.generation(), 1u);
+    cfg.set(&ModifyConfig::y, 20);
+    ASSERT_TRUE(store.save(cfg));
+    ASSERT_EQ(store.generation(), 2u);
+
+    ModifyConfig loaded{};
+    ASSERT_TRUE(store.load(loaded));
+    ASSERT_EQ(loaded.y, 20);
+    store.close();
+    std::remove(path);
+}
+#endif
+
+// --- Test Suite per il journal su flash ---
+struct JournalConfig {
+    uint32_t counter;
+    int32_t level;
+    char blob[200];
+};
+
+// NOR flash in RAM: program only clears bits, erase sets a sector to 0xFF
+struct FakeFlash {
+    std::vector<unsigned char> mem;
+    uint32_t sectorSize;
+    int erases = 0;
+    size_t programmed = 0;
+    uint32_t lastProgram = 0;
+
+    FakeFlash(uint32_t sector, uint32_t sectors) : mem(sector * sectors, 0xFF), sectorSize(sector) {}
+
+    configly::FlashOps ops(uint32_t sectorsPerBank) {
+        configly::FlashOps o;
+        o.read = [](void* c, uint32_t addr, void* out, size_t n) {
+            auto* f = static_cast<FakeFlash*>(c);
+            std::memcpy(out, f->mem.data() + addr, n);
+            return true;
+        };
+        o.program = [](void* c, uint32_t addr, const void* data, size_t n) {
+            auto* f = static_cast<FakeFlash*>(c);
+            const auto* bytes = static_cast<const unsigned char*>(data);
+            for (size_t i = 0; i < n; ++i) {
+                f->mem[addr + i] &= bytes[i];
+            }
+            f->programmed += n;
+            f->lastProgram = addr;
+            return true;
+        };
+        o.erase = [](void* c, uint32_t addr) {
+            auto* f = static_cast<FakeFlash*>(c);
+            std::memset(f->mem.data() + addr, 0xFF, f->sectorSize);
+            ++f->erases;
+            return true;
+        };
+        o.context = this;
+        o.sectorSize = sectorSize;
+        o.sectorsPerBank = sectorsPerBank;
+        return o;
+    }
+};
+
+TEST(ConfiglyJournalTest, TracksDirtyFieldsSinceSave) {
+    configly::Owned<Configly<JournalConfig>> cfg;
+    cfg.setDefault({});
+    cfg.set(&JournalConfig::level, 1);
+    ASSERT_EQ(cfg.dirtyFields(), 0u);  // no save function: nothing tracked
+
+    cfg.setSaveFunction(+[](const JournalConfig&) { return true; });
+    cfg.set(&JournalConfig::level, 2);
+    cfg.modify([](JournalConfig& c) { c.blob[150] = 'x'; });
+    ASSERT_EQ(cfg.dirtyFields(), 0b110u);
+    ASSERT_TRUE(cfg.save());
+    ASSERT_EQ(cfg.dirtyFields(), 0u);
+
+    cfg.setSaveFunction(+[](const JournalConfig&) { return false; });
+    cfg.set<&JournalConfig::counter>(4u);
+    ASSERT_FALSE(cfg.save());
+    ASSERT_EQ(cfg.dirtyFields(), 0b001u);  // failed save keeps them dirty
+}
+
+TEST(ConfiglyJournalTest, AppendsDeltasAndReplays) {
+    FakeFlash flash(1024, 2);
+    configly::Owned<Configly<JournalConfig>> cfg;
+    cfg.setDefault({});
+    configly::FlashJournal<JournalConfig> journal(flash.ops(1));
+    journal.attach(cfg);
+
+    cfg.set(&JournalConfig::counter, 1u);
+    ASSERT_TRUE(cfg.save());  // empty flash: full base image
+    ASSERT_EQ(flash.erases, 1);
+    ASSERT_EQ(journal.generation(), 1u);
+
+    flash.programmed = 0;
+    cfg.set(&JournalConfig::level, 5);
+    ASSERT_TRUE(cfg.save());
+    ASSERT_EQ(flash.erases, 1);
+    ASSERT_EQ(flash.programmed, sizeof(configly::FlashJournal<JournalConfig>::RecordHeader) + 4);
+
+    flash.programmed = 0;
+    ASSERT_TRUE(cfg.save());  // nothing dirty, nothing written
+    ASSERT_EQ(flash.programmed, 0u);
+
+    {
+        configly::Owned<Configly<JournalConfig>> restored;
+        restored.setDefault({});
+        configly::FlashJournal<JournalConfig> other(flash.ops(1));
+        other.attach(restored);
+        ASSERT_TRUE(restored.load());
+        ASSERT_EQ(restored.get(&JournalConfig::counter), 1u);
+        ASSERT_EQ(restored.get(&JournalConfig::level), 5);
+        ASSERT_EQ(restored.dirtyFields(), 0u);
+    }
+
+    // fill the log until it compacts into the other bank
+    uint32_t i = 1;
+    while (flash.erases == 1) {
+        cfg.set(&JournalConfig::counter, ++i);
+        ASSERT_TRUE(cfg.save());
+    }
+    ASSERT_EQ(journal.generation(), 2u);
+    ASSERT_EQ(journal.logBytes(), 0u);
+
+    cfg.set(&JournalConfig::level, 6);
+    ASSERT_TRUE(cfg.save());
+    cfg.set(&JournalConfig::level, 7);
+    ASSERT_TRUE(cfg.save());
+    cfg.modify([](JournalConfig& c) { std::memset(c.blob, 'z', sizeof(c.blob)); });
+    ASSERT_TRUE(cfg.save());
+    flash.mem[flash.lastProgram] ^= 0x01;  // tear the last record, longer than a replay chunk
+
+    configly::Owned<Configly<JournalConfig>> restored;
+    restored.setDefault({});
+    configly::FlashJournal<JournalConfig> other(flash.ops(1));
+    other.attach(restored);
+    ASSERT_TRUE(restored.load());
+    ASSERT_EQ(restored.get(&JournalConfig::counter), i);
+    ASSERT_EQ(restored.get(&JournalConfig::level), 7);
+    JournalConfig loaded{};
+    restored.getAll(loaded);
+    ASSERT_EQ(loaded.blob[0], 0);
+    ASSERT_EQ(loaded.blob[sizeof(loaded.blob) - 1], 0);
+}
+
+// --- Test Suite per i config non riflettibili ---
+struct ZeroedBlock {
+    ZeroedBlock() { std::memset(raw, 0, sizeof(raw)); }  // not constexpr: no literal T
+    unsigned char raw[8];
+};
+
+struct BlockConfig {
+    uint32_t id;
+    ZeroedBlock block;
+};
+
+struct BaseSettings {
+    int level;
+};
+
+struct DerivedSettings : BaseSettings {
+    int extra;
+};
+
+enum class LedMode : uint8_t { Off, Blink, On };
+
+struct PanelConfig {
+    unsigned brightness : 5;
+    LedMode mode : 2;
+    int offset : 6;
+    uint16_t timeoutMs;
+    configly::fixed_string<16> label;
+};
+
+struct FlagConfig {
+    bool enabled : 1;  // as wide as bool: only CONFIGLY_OPAQUE can say so
+    bool verbose : 1;
+    uint8_t level;
+};
+
+CONFIGLY_OPAQUE(FlagConfig);
+
+static_assert(!detail::reflectable<PanelConfig>());
+static_assert(!detail::reflectable<FlagConfig>());
+static_assert(!detail::reflectable<BlockConfig>());
+static_assert(!detail::reflectable<DerivedSettings>());
+static_assert(detail::reflectable<JournalConfig>());
+
+TEST(ConfiglyOpaqueTest, UnreflectableConfigsTrackTheWholeStruct) {
+    configly::Owned<Configly<DerivedSettings>> derived;
+    derived.setDefault({{1}, 2});
+    int calls = 0;
+    derived.onChange(&DerivedSettings::level, countCallback, &calls);
+
+    ASSERT_TRUE(derived.set(&DerivedSettings::level, 5));
+    ASSERT_EQ(calls, 1);
+    ASSERT_TRUE(derived.set<&DerivedSettings::extra>(3));
+    ASSERT_EQ(calls, 1);  // callbacks still compare their own bytes
+    ASSERT_EQ(derived.get(&DerivedSettings::extra), 3);
+    ASSERT_EQ(derived.diffSince(2), 1u);  // one field, covering sizeof(T)
+
+    configly::Owned<Configly<BlockConfig>> block;
+    block.setDefault({});
+    block.modify([](BlockConfig& c) { c.block.raw[3] = 7; });
+    ASSERT_EQ(block.get(&BlockConfig::block).raw[3], 7);
+    ASSERT_TRUE(block.set<&BlockConfig::id>(9u));
+    ASSERT_EQ(block.version(), 3u);
+}
+
+TEST(ConfiglyOpaqueTest, BitFieldConfigsCopyWhole) {
+    configly::Owned<Configly<PanelConfig>> panel;
+    PanelConfig defaults{};
+    defaults.brightness = 20;
+    defaults.label = "front";
+    panel.setDefault(defaults);
+
+    int calls = 0;
+    panel.onChange(&PanelConfig::timeoutMs, +[](const uint16_t&, void* c) { ++*static_cast<int*>(c); }, &calls);
+    panel.modify([](PanelConfig& c) {
+        c.mode = LedMode::Blink;
+        c.offset = -7;
+    });
+    ASSERT_EQ(calls, 0);
+    ASSERT_TRUE(panel.set(&PanelConfig::timeoutMs, uint16_t{500}));
+    ASSERT_EQ(calls, 1);
+
+    PanelConfig now{};
+    panel.getAll(now);
+    ASSERT_EQ(now.brightness, 20u);
+    ASSERT_EQ(now.mode, LedMode::Blink);
+    ASSERT_EQ(now.offset, -7);
+    ASSERT_EQ(now.label, "front");
+
+    configly::Owned<Configly<FlagConfig>> flags;
+    flags.setDefault({});
+    flags.modify([](FlagConfig& c) { c.verbose = true; });
+    FlagConfig f{};
+    flags.getAll(f);
+    ASSERT_TRUE(f.verbose);
+    ASSERT_FALSE(f.enabled);
+}
 
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,338 @@
+#include <configly/configly.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ===================================================================
+// Concurrency stress harness for the seq protocol.
+//
+// R reader threads race W writer threads on a config whose every word is
+// derived from a stamp (writer id << 48 | write counter) and whose last word
+// is a checksum of the others. Each reader checks every snapshot for
+//   - torn   : a word or the checksum does not match the stamp
+//   - order  : a writer's counter went backwards (not linearizable), or
+//              version() decreased
+// and the run fails if any scenario saw one. Reported per scenario:
+// reads/s and writes/s over all threads, and readRetries() per read, so the
+// same runs double as a throughput benchmark.
+//
+// Usage: configly_stress [--quick] [--duration-ms N] [--readers 1,4,16]
+//                        [--writers 1,4] [--sizes 64,1024,16384] [--buffers 2,4]
+//
+// Configure with -DCONFIGLY_STRESS_TSAN=ON for a ThreadSanitizer build; the
+// seqlock copies themselves race by design and are suppressed in tsan.supp,
+// so what is left points at everything else.
+// ===================================================================
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr unsigned kCounterBits = 48;
+constexpr std::uint64_t kCounterMask = (std::uint64_t{1} << kCounterBits) - 1;
+
+inline std::uint64_t mix(std::uint64_t x) {
+    // splitmix64 finalizer
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+// words[0] is the stamp, words[Words - 1] the checksum of everything before it
+template<std::size_t Words>
+struct Checked {
+    static_assert(Words >= 2, "stamp and checksum need two words");
+    std::uint64_t words[Words];
+};
+
+template<std::size_t Words>
+void fill(Checked<Words>& c, std::uint64_t stamp) {
+    std::uint64_t sum = c.words[0] = stamp;
+    for (std::size_t i = 1; i + 1 < Words; ++i) {
+        c.words[i] = mix(stamp + i);
+        sum ^= c.words[i];
+    }
+    c.words[Words - 1] = mix(sum);
+}
+
+template<std::size_t Words>
+bool intact(const Checked<Words>& c) {
+    const std::uint64_t stamp = c.words[0];
+    std::uint64_t sum = stamp;
+    bool ok = true;
+    for (std::size_t i = 1; i + 1 < Words; ++i) {
+        ok &= c.words[i] == mix(stamp + i);
+        sum ^= c.words[i];
+    }
+    return ok && c.words[Words - 1] == mix(sum);
+}
+
+template<typename C, std::size_t Buffers>
+using StressConfigly = Configly<C, 1, Buffers, configly::AtomicStats>;
+
+enum class ReadOp { GetAll, View, Cached };
+
+struct Options {
+    std::chrono::milliseconds duration{200};
+    std::vector<int> readers{1, 4, 16};
+    std::vector<int> writers{1, 4};
+    std::vector<std::size_t> sizes{64, 1024, 16384};
+    std::vector<std::size_t> buffers{2, 4};
+};
+
+struct Result {
+    std::uint64_t reads = 0;
+    std::uint64_t writes = 0;
+    std::uint64_t retries = 0;
+    std::uint64_t torn = 0;
+    std::uint64_t order = 0;
+    double seconds = 0;
+};
+
+// per-reader linearizability bookkeeping
+struct History {
+    std::vector<std::uint64_t> lastCounter;
+    std::uint64_t lastVersion = 0;
+    std::uint64_t violations = 0;
+
+    explicit History(int writers) : lastCounter(static_cast<std::size_t>(writers), 0) {}
+
+    void observe(std::uint64_t stamp, std::uint64_t version) {
+        if (version < lastVersion) {
+            ++violations;
+        }
+        lastVersion = version;
+        const std::size_t writer = static_cast<std::size_t>(stamp >> kCounterBits);
+        const std::uint64_t counter = stamp & kCounterMask;
+        if (counter == 0) {
+            return;  // the defaults
+        }
+        if (writer >= lastCounter.size() || counter < lastCounter[writer]) {
+            ++violations;
+            return;
+        }
+        lastCounter[writer] = counter;
+    }
+};
+
+template<std::size_t Words, std::size_t Buffers>
+Result runScenario(const Options& opt, int readers, int writers, ReadOp readOp) {
+    using Config = Checked<Words>;
+    using Cfg = StressConfigly<Config, Buffers>;
+    auto& cfg = Cfg::instance();
+    Config defaults;
+    fill(defaults, 0);
+    cfg.setDefault(defaults);
+
+    std::atomic<int> ready{0};
+    std::atomic<bool> go{false};
+    std::atomic<bool> stop{false};
+    std::vector<Result> results(static_cast<std::size_t>(readers + writers));
+
+    std::vector<std::thread> threads;
+    for (int w = 0; w < writers; ++w) {
+        threads.emplace_back([&, w]() {
+            Result& mine = results[static_cast<std::size_t>(readers + w)];
+            Config next;
+            std::uint64_t counter = 0;
+            ready.fetch_add(1);
+            while (!go.load(std::memory_order_acquire)) {}
+            while (!stop.load(std::memory_order_relaxed)) {
+                const std::uint64_t stamp = (static_cast<std::uint64_t>(w) << kCounterBits) | ++counter;
+                // alternate the two full-buffer write paths
+                if (counter & 1u) {
+                    fill(next, stamp);
+                    cfg.update(next);
+                } else {
+                    cfg.modify([stamp](Config& c) { fill(c, stamp); });
+                }
+                ++mine.writes;
+            }
+        });
+    }
+
+    for (int r = 0; r < readers; ++r) {
+        threads.emplace_back([&, r]() {
+            Result& mine = results[static_cast<std::size_t>(r)];
+            History history(writers);
+            Config snapshot;
+            typename Cfg::LocalCache cache(cfg);
+            ready.fetch_add(1);
+            while (!go.load(std::memory_order_acquire)) {}
+            while (!stop.load(std::memory_order_relaxed)) {
+                // a snapshot is at least as new as a version read before it
+                const std::uint64_t version = cfg.version();
+                std::uint64_t stamp = 0;
+                bool ok = false;
+                if (readOp == ReadOp::GetAll) {
+                    cfg.getAll(snapshot);
+                    ok = intact(snapshot);
+                    stamp = snapshot.words[0];
+                } else if (readOp == ReadOp::View) {
+                    for (auto guard = cfg.view();; guard.retry()) {
+                        ok = intact(*guard);
+                        stamp = guard->words[0];
+                        if (guard.valid()) {
+                            break;  // only a validated view counts
+                        }
+                    }
+                } else {
+                    const Config& cached = cache.get();
+                    ok = intact(cached);
+                    stamp = cached.words[0];
+                }
+                if (!ok) {
+                    ++mine.torn;
+                }
+                history.observe(stamp, readOp == ReadOp::Cached ? cache.version() : version);
+                ++mine.reads;
+            }
+            mine.order = history.violations;
+        });
+    }
+
+    while (ready.load() != readers + writers) {
+        std::this_thread::yield();
+    }
+    const std::uint64_t retriesBefore = cfg.readRetries();
+    const auto start = Clock::now();
+    go.store(true, std::memory_order_release);
+    std::this_thread::sleep_for(opt.duration);
+    stop.store(true);
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    Result total;
+    total.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    total.retries = cfg.readRetries() - retriesBefore;
+    for (const Result& r : results) {
+        total.reads += r.reads;
+        total.writes += r.writes;
+        total.torn += r.torn;
+        total.order += r.order;
+    }
+    return total;
+}
+
+const char* name(ReadOp op) {
+    switch (op) {
+        case ReadOp::GetAll: return "getAll";
+        case ReadOp::View:   return "view";
+        default:             return "cached";
+    }
+}
+
+// false if any scenario saw a violation
+template<std::size_t Words, std::size_t Buffers>
+bool runSize(const Options& opt) {
+    bool clean = true;
+    for (int readers : opt.readers) {
+        for (int writers : opt.writers) {
+            for (ReadOp readOp : {ReadOp::GetAll, ReadOp::View, ReadOp::Cached}) {
+                const Result r = runScenario<Words, Buffers>(opt, readers, writers, readOp);
+                const double reads = static_cast<double>(r.reads);
+                std::printf("%7zu %7zu %7d %7d %-7s %12.0f %12.0f %11.5f %7llu %7llu\n",
+                            sizeof(Checked<Words>), Buffers, readers, writers, name(readOp),
+                            reads / r.seconds, static_cast<double>(r.writes) / r.seconds,
+                            r.reads > 0 ? static_cast<double>(r.retries) / reads : 0.0,
+                            static_cast<unsigned long long>(r.torn),
+                            static_cast<unsigned long long>(r.order));
+                std::fflush(stdout);
+                clean &= r.torn == 0 && r.order == 0;
+            }
+        }
+    }
+    return clean;
+}
+
+template<std::size_t Words>
+bool runBuffers(const Options& opt) {
+    bool clean = true;
+    for (std::size_t buffers : opt.buffers) {
+        if (buffers == 2) {
+            clean &= runSize<Words, 2>(opt);
+        } else if (buffers == 4) {
+            clean &= runSize<Words, 4>(opt);
+        } else {
+            std::fprintf(stderr, "# ring of %zu buffers not built in, skipped\n", buffers);
+        }
+    }
+    return clean;
+}
+
+template<typename V>
+std::vector<V> parseList(const char* text) {
+    std::vector<V> values;
+    const std::string s(text);
+    std::size_t pos = 0;
+    while (pos < s.size()) {
+        std::size_t next = s.find(',', pos);
+        if (next == std::string::npos) {
+            next = s.size();
+        }
+        values.push_back(static_cast<V>(std::strtoull(s.substr(pos, next - pos).c_str(), nullptr, 10)));
+        pos = next + 1;
+    }
+    return values;
+}
+
+bool wantSize(const Options& opt, std::size_t size) {
+    return std::find(opt.sizes.begin(), opt.sizes.end(), size) != opt.sizes.end();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--quick") {
+            opt.duration = std::chrono::milliseconds(20);
+            opt.readers = {1, 4};
+            opt.writers = {1, 2};
+            opt.sizes = {64, 1024};
+        } else if (arg == "--duration-ms" && hasValue) {
+            opt.duration = std::chrono::milliseconds(std::atoi(argv[++i]));
+        } else if (arg == "--readers" && hasValue) {
+            opt.readers = parseList<int>(argv[++i]);
+        } else if (arg == "--writers" && hasValue) {
+            opt.writers = parseList<int>(argv[++i]);
+        } else if (arg == "--sizes" && hasValue) {
+            opt.sizes = parseList<std::size_t>(argv[++i]);
+        } else if (arg == "--buffers" && hasValue) {
+            opt.buffers = parseList<std::size_t>(argv[++i]);
+        } else {
+            std::fprintf(stderr,
+                         "usage: %s [--quick] [--duration-ms N] [--readers 1,4,16] [--writers 1,4] "
+                         "[--sizes 64,1024,16384] [--buffers 2,4]\n",
+                         argv[0]);
+            return 1;
+        }
+    }
+
+    std::printf("# hardware threads: %u\n", std::thread::hardware_concurrency());
+    std::printf("%7s %7s %7s %7s %-7s %12s %12s %11s %7s %7s\n",
+                "size", "buffers", "readers", "writers", "read", "reads/s", "writes/s", "retries/op",
+                "torn", "order");
+
+    bool clean = true;
+    if (wantSize(opt, 64))    clean &= runBuffers<8>(opt);
+    if (wantSize(opt, 1024))  clean &= runBuffers<128>(opt);
+    if (wantSize(opt, 16384)) clean &= runBuffers<2048>(opt);
+
+    if (!clean) {
+        std::printf("FAILED: torn or out-of-order snapshots observed\n");
+        return 1;
+    }
+    return 0;
+}